@@ -4,12 +4,17 @@
 
 #include "graph.h"
 #include "aco_heuristic.h"
+#include "split.h"
 #include "limits"
 
 namespace ace {
 
-    aco_heuristic::aco_heuristic(const string &filename) {
-        g = new maoa::Graph(filename);
+    aco_heuristic::aco_heuristic(const string &filename, const maoa::LoadOptions &options) {
+        g.reset(new maoa::Graph(filename, options));
+    }
+
+    aco_heuristic::aco_heuristic(const maoa::InstanceData &data, const maoa::LoadOptions &options) {
+        g.reset(new maoa::Graph(data, options));
     }
 
     std::list<maoa::Tour> aco_heuristic::run(int nb_iter, int nb_ants, float beta, float alpha, float q0, float t0) {
@@ -24,13 +29,9 @@ namespace ace {
 
         //std::cout<<"Done initializing ants\n";         //initialization pheromones
 
-        std::stringstream ss;
         for (int i = 0; i < g->nodeNum(); i++) {
             for (int j = i + 1; j < g->nodeNum(); j++) {
-                ss << i << j;
-                pheromones.insert(std::pair<string, float>(ss.str(), t0));
-                ss.str("");
-                ss.clear();
+                pheromones.insert(std::make_pair(edge(i, j), t0));
             }
         }
 
@@ -38,9 +39,11 @@ namespace ace {
 
         float dst = std::numeric_limits<float>::max();
         int bestAnt = 0;
-        std::list<int> bestPath;
+        std::list<maoa::Tour> bestTours;
+        const int depotId = g->depotId();
+        std::vector<int> giantTour;
 
-        std::list<int>::iterator itm;
+        maoa::CityList::iterator itm;
         for (int j = 0; j < nb_iter; j++) {
             for (int i = 0; i < nb_ants; i++) {
                 while (Ants[i].visited < g->nodeNum()) {
@@ -55,25 +58,28 @@ namespace ace {
                     itm = Ants[i].path.begin();
                     Ants[i].path.insert(itm, 0);
                 }
-                //making the distance longer if you use too many vehicules
-                int cpt = 0;
-                for (itm = Ants[i].path.begin(); itm != Ants[i].path.end(); ++itm) {
-                    if(*itm == 0){
-                        cpt++;
-                    }
+                // Decode the ant through an optimal split of its customers, in the order of the path:
+                // the depot returns chosen while walking are only a feasible partition.
+                giantTour.clear();
+                for (int c : Ants[i].path) {
+                    if (c != depotId) giantTour.push_back(c);
                 }
-                if(cpt > g->vehiclesNum()+1){
-                    //std::cout << "malus"<< "\n";
-                    Ants[i].distance = std::numeric_limits<float>::max();;
+                std::list<maoa::Tour> tours = maoa::split::split(*g, giantTour, g->vehiclesNum());
+                if (tours.empty()) {
+                    // Too many vehicles.
+                    Ants[i].distance = std::numeric_limits<float>::max();
+                } else {
+                    Ants[i].distance = 0;
+                    for (const maoa::Tour &t : tours) Ants[i].distance += t.cost;
                 }
                 if (dst > Ants[i].distance) {
                     bestAnt = Ants[i].id;
-                    bestPath = Ants[i].path;
+                    bestTours.swap(tours);
                     dst = Ants[i].distance;
                     //std::cout << "\n new best ant found ;"<< dst << "\n";         //getting the best ant
                 }
             }
-            updatePheromones(Ants[bestAnt], alpha);
+            updatePheromones(bestTours, dst, alpha);
             evaporatePheromones(alpha, t0);
 
             if(j !=  nb_iter-1){
@@ -83,34 +89,24 @@ namespace ace {
 
         std::cout << "best Ant :"<< Ants[bestAnt].id  << " Distance :" << dst << "\n";
 
-        std::list<maoa::Tour> clusters;
-        maoa::Tour currentCluster;
-        const int depotId = g->depotId();
-        std::list<int>::iterator itbp;
-        for(itbp = ++bestPath.begin(); itbp != bestPath.end(); itbp ++){
-            if(*itbp == 0){
-                clusters.push_back(currentCluster);
-                currentCluster = maoa::Tour();
-            }else{
-                currentCluster.addCity(*itbp, g->getDemand(*itbp));
-            }
-        }
-        return clusters;
+        return bestTours;
 
     }
 
     void aco_heuristic::selectNode(ant &a, float q0, int beta) {
         float q =  getRandom();
-        std::list<int>::iterator ita;
-        std::list<int>::iterator it;
+        maoa::CityList::iterator ita;
+        maoa::CityList::iterator it;
         double j = 0;
         int nextNode = -1;
+        const double *positionRow = g->distanceRow(a.position);
+        const float *demands = g->demands();
         if (q < q0) {
             for (int i = 0; i < g->nodeNum(); ++i) {
                 ita = std::find(a.path.begin(), a.path.end(), i);
-                if (ita == a.path.end() && *ita != a.position) { // node not visited : calculate its value
-                    if (a.capacity - g->getData(i).demand >= 0) {
-                        double tmp = getpheromones(a.position, i) * pow((1 / g->getDistance(a.position, i))*1, beta);
+                if (ita == a.path.end()) { // node not visited : calculate its value
+                    if (a.capacity - demands[i] >= 0) {
+                        double tmp = getpheromones(a.position, i) * pow((1 / positionRow[i])*1, beta);
                         if (tmp > j) {
                             j = tmp;
                             nextNode = i;
@@ -131,7 +127,7 @@ namespace ace {
                 a.distance += g->getDistance(a.position, g->depotId());
                 a.position = nextNode;
                 it = a.path.begin();
-                a.capacity -= g->getData(nextNode).demand;
+                a.capacity -= demands[nextNode];
                 a.visited ++;
                 a.path.insert(it, nextNode);
                 return;
@@ -141,9 +137,9 @@ namespace ace {
             float sumPaths = 0;
             for (int i = 0; i != g->nodeNum(); i++) {
                 ita = std::find(a.path.begin(), a.path.end(), i);
-                if (ita == a.path.end() && *ita != a.position) { // node not visited : calculate its value
-                    if (a.capacity - g->getData(i).demand >= 0) {
-                        sumPaths += getpheromones(a.position, i) * pow((1 / g->getDistance(a.position, i)) * 1, beta);
+                if (ita == a.path.end()) { // node not visited : calculate its value
+                    if (a.capacity - demands[i] >= 0) {
+                        sumPaths += getpheromones(a.position, i) * pow((1 / positionRow[i]) * 1, beta);
                     }
                 }
             }
@@ -152,9 +148,9 @@ namespace ace {
             std::map<double, int> proba;
             for (int i = 0; i < g->nodeNum(); ++i) {
                 ita = std::find(a.path.begin(), a.path.end(), i);
-                if (ita == a.path.end() && *ita != a.position) { // node not visited : calculate its value
-                    if (a.capacity - g->getData(i).demand >= 0) {
-                        double tmp = (getpheromones(a.position, i) * pow(1 / g->getDistance(a.position, i), beta)) /
+                if (ita == a.path.end()) { // node not visited : calculate its value
+                    if (a.capacity - demands[i] >= 0) {
+                        double tmp = (getpheromones(a.position, i) * pow(1 / positionRow[i], beta)) /
                                      sumPaths;
                         proba.insert(std::pair<double, int>(tmp, i));
                     }
@@ -175,7 +171,7 @@ namespace ace {
                 totpop += itproba->first;
                 if (totpop > rnd) {
                     a.distance += g->getDistance(a.position, itproba->second);
-                    a.capacity -= g->getData(itproba->second).demand;
+                    a.capacity -= demands[itproba->second];
                     a.position = itproba->second;
                     it = a.path.begin();
                     a.visited ++;
@@ -187,20 +183,22 @@ namespace ace {
     }
 
 
-    void aco_heuristic::updatePheromones(ant &a, float alpha) {
-        //std::cout << " updating pheromones \n";
-        //TODO itrttre da,ns lautre sens
-        int prevPosition = a.position;
-        std::list<int>::iterator it;
-        for (it = ++a.path.begin(); it != a.path.end(); ++it) {
-            addpheromones(prevPosition, *it, a.distance,alpha);
-            prevPosition = *it;
+    void aco_heuristic::updatePheromones(const std::list<maoa::Tour> &tours, float distance, float alpha) {
+        // Reward the edges of the split solution, depot returns included.
+        const int depotId = g->depotId();
+        for (const maoa::Tour &t : tours) {
+            int prevPosition = depotId;
+            for (int c : t.cities) {
+                addpheromones(prevPosition, c, distance, alpha);
+                prevPosition = c;
+            }
+            addpheromones(prevPosition, depotId, distance, alpha);
         }
     }
 
     void aco_heuristic::evaporatePheromones(float alpha, float t0) {
         //std::cout << " evaporate pheromones : ";
-        std::map<string, float>::iterator phit;
+        std::map<Edge, float>::iterator phit;
         for (phit = pheromones.begin(); phit != pheromones.end(); phit++) {
             //std::cout << phit->second *100000<< "|";
             float tmp = (phit->second * (1 - alpha )) + (t0 * alpha);
@@ -210,36 +208,15 @@ namespace ace {
     }
 
     float aco_heuristic::getpheromones(int nodeA, int nodeB) {
-        std::stringstream ss;
-        ss << nodeA << nodeB;
-        std::map<string, float>::iterator it;
-        it = pheromones.find(ss.str());
-        if (it != pheromones.end()) {
-            return it->second;
-        } else {
-            ss.str("");
-            ss.clear();
-            ss << nodeB << nodeA;
-            return pheromones.find(ss.str())->second;
-
-        }
+        auto it = pheromones.find(edge(nodeA, nodeB));
+        return it != pheromones.end() ? it->second : 0;
     }
 
     void aco_heuristic::addpheromones(int nodeA, int nodeB, float value, float alpha) {
-        std::stringstream ss;
-        ss << nodeA << nodeB;
-        std::map<string, float>::iterator it;
-        it = pheromones.find(ss.str());
-        if (it != pheromones.end()) {
-            //TODO test values
-            it->second = ((1 - alpha) * it->second) + (alpha * (1 / value));
-        } else {
-            ss.str("");
-            ss.clear();
-            ss << nodeB << nodeA;
-            pheromones.find(ss.str())->second += ((1 - alpha) * it->second) + (alpha * 1 / value);
-
-        }
+        auto it = pheromones.find(edge(nodeA, nodeB));
+        if (it == pheromones.end()) return;
+        //TODO test values
+        it->second = ((1 - alpha) * it->second) + (alpha * (1 / value));
     }
 
     void aco_heuristic::resetAnts(int nb_ants, ant Ants[]) {
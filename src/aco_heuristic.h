@@ -5,6 +5,8 @@
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <utility>
 
 
 #include "graph.h"
@@ -15,8 +17,8 @@ namespace ace {
 
     struct ant {
         int id, visited;
-        std::list<int> path;
-        std::list<int>::iterator it;
+        maoa::CityList path;
+        maoa::CityList::iterator it;
         float capacity;
         int position;
         float distance;
@@ -30,15 +32,25 @@ namespace ace {
 
     class aco_heuristic {
     public:
-        explicit aco_heuristic(const string &filename);
+        explicit aco_heuristic(const string &filename, const maoa::LoadOptions &options = maoa::LoadOptions());
+
+        explicit aco_heuristic(const maoa::InstanceData &data, const maoa::LoadOptions &options = maoa::LoadOptions());
+
+        /*! Graph the tours returned by run() refer to. */
+        const maoa::Graph &graph() const { return *g; }
 
         std::list<maoa::Tour> run(int nb_iter, int nb_ants, float beta, float alpha, float q0, float t0);
 
-        std::map<string, float> pheromones;
+        /*! Undirected edge, as (smaller id, larger id). */
+        typedef std::pair<int, int> Edge;
+        static Edge edge(int a, int b) { return a < b ? Edge(a, b) : Edge(b, a); }
+
+        std::map<Edge, float> pheromones;
     private:
         void selectNode(ant &a, float q0, int beta);
 
-        void updatePheromones(ant &a, float alpha);
+        /*! Deposits pheromones on the edges of \a tours, the routes of the best ant found so far. */
+        void updatePheromones(const std::list<maoa::Tour> &tours, float distance, float alpha);
 
         void evaporatePheromones(float alpha, float t0);
 
@@ -50,7 +62,7 @@ namespace ace {
 
         float getRandom();
 
-        maoa::Graph *g;
+        std::unique_ptr<maoa::Graph> g;
     };
 }
 #endif
\ No newline at end of file
@@ -10,7 +10,7 @@ int main(int argc, char** argv) {
     ace::aco_heuristic ace("../data/Test/1.vrp");
     std::list<maoa::Tour> tours = ace.run(20,20,2.3,0.1,0.2,0.00001);
     for (auto & c : tours) {
-       c.print();
+       c.print(ace.graph());
     }
 
     drawUtils.drawTours(tours, g);
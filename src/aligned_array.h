@@ -0,0 +1,60 @@
+#ifndef PMAOA_ALIGNED_ARRAY_H
+#define PMAOA_ALIGNED_ARRAY_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace maoa {
+
+    /*!
+     * Fixed-size array of trivially copyable elements whose first element is
+     * aligned on a cache line, so that loops streaming over it can be
+     * vectorized without peeling. The allocation is padded to a whole number
+     * of cache lines.
+     */
+    template <typename T>
+    class AlignedArray {
+    public:
+        static constexpr std::size_t ALIGNMENT = 64;
+
+        AlignedArray() : _data(nullptr), _size(0) {}
+        explicit AlignedArray(std::size_t size) : _data(nullptr), _size(0) { resize(size); }
+        AlignedArray(const AlignedArray &other) : _data(nullptr), _size(0) { *this = other; }
+        ~AlignedArray() { std::free(_data); }
+
+        AlignedArray &operator=(const AlignedArray &other) {
+            if (this != &other) {
+                resize(other._size);
+                if (_size > 0) memcpy(_data, other._data, _size * sizeof(T));
+            }
+            return *this;
+        }
+
+        /*! Reallocates the array with \a size zeroed elements. */
+        void resize(std::size_t size) {
+            std::free(_data);
+            _data = nullptr;
+            _size = size;
+            if (size == 0) return;
+            std::size_t bytes = (size * sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+            void *ptr = nullptr;
+            if (posix_memalign(&ptr, ALIGNMENT, bytes) != 0) throw std::bad_alloc();
+            memset(ptr, 0, bytes);
+            _data = static_cast<T *>(ptr);
+        }
+
+        T &operator[](std::size_t i) { return _data[i]; }
+        const T &operator[](std::size_t i) const { return _data[i]; }
+        T *data() { return _data; }
+        const T *data() const { return _data; }
+        std::size_t size() const { return _size; }
+
+    private:
+        T *_data;
+        std::size_t _size;
+    };
+}
+
+#endif //PMAOA_ALIGNED_ARRAY_H
@@ -23,13 +23,14 @@ namespace maoa {
 
 
             lemon::FullGraph::Node s = g(startingPoint);
-            currentCluster.addCity(startingPoint, g.getDemand(s));
+            currentCluster.addCity(startingPoint, g.getDemand(s), g);
 
-            std::list<int> nodeIds(nodeNum);
+            CityList nodeIds(nodeNum);
             std::iota(nodeIds.begin(), nodeIds.end(), 0);
             // Sorting by decreasing distance
+            const double *startingRow = g.distanceRow(startingPoint);
             nodeIds.sort([&](int a, int b) {
-                return g.getDistance(a, startingPoint) > g.getDistance(b, startingPoint);
+                return startingRow[a] > startingRow[b];
             });
 
             auto it = nodeIds.end();
@@ -38,16 +39,16 @@ namespace maoa {
                 int nodeId = (*it);
                 if (nodeId == depotId || nodeId == startingPoint) {
                     // Discard depot
-                    nodeIds.erase(it, std::next(it));
+                    it = nodeIds.erase(it);
                     continue;
                 }
 
                 lemon::FullGraph::Node u = g(nodeId);
                 if (currentCluster.capacity + g.getDemand(u) <= g.capacity()) {
                     // Add city to cluster
-                    currentCluster.addCity(nodeId, g.getDemand(u));
+                    currentCluster.addCity(nodeId, g.getDemand(u), g);
                     // Erase city from unvisited cities.
-                    nodeIds.erase(it, std::next(it));
+                    it = nodeIds.erase(it);
                 } else {
                     // Current node could not be added to current cluster. Two possibilities:
                     //
@@ -61,11 +62,12 @@ namespace maoa {
                         // Reset iterator to the end of the list
                         startingPoint = (*--nodeIds.end());
                         s = g(startingPoint);
-                        currentCluster.addCity(startingPoint, g.getDemand(s));
+                        currentCluster.addCity(startingPoint, g.getDemand(s), g);
                         nodeIds.erase(--nodeIds.end(), nodeIds.end());
                         // Sort cities according to new starting point
+                        startingRow = g.distanceRow(startingPoint);
                         nodeIds.sort([&](int a, int b) {
-                            return g.getDistance(a, startingPoint) > g.getDistance(b, startingPoint);
+                            return startingRow[a] > startingRow[b];
                         });
                         it = nodeIds.end();
                     }
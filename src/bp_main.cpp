@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include "graph.h"
 #include "bp_heuristic.h"
 #include "draw.h"
@@ -10,12 +12,18 @@ int main(int argc, char** argv) {
         std::cout << "Options:" << std::endl;
         std::cout << "\t-db\t Draw solution before iterative descent (with gnuplot)" << std::endl;
         std::cout << "\t-da\t Draw solution after iterative descent (with gnuplot)" << std::endl;
+        std::cout << "\t-nint\t Round distances to the nearest integer (TSPLIB)" << std::endl;
+        std::cout << "\t-int\t Evaluate moves with integer costs (rounded distances)" << std::endl;
+        std::cout << "\t-hilbert\t Renumber customers along a Hilbert curve" << std::endl;
+        std::cout << "\t-best\t Apply the best 2-opt move of each tour instead of the first one" << std::endl;
         exit(1);
     }
 
     string filepath{argv[1]};
     bool drawSolutionBefore = false;
     bool drawSolutionAfter = false;
+    maoa::LoadOptions options;
+    maoa::idesc::Improvement improvement = maoa::idesc::Improvement::First;
 
     for (int i = 2; i < argc; i++) {
         if (strncmp(argv[i], "-db", 3) == 0) {
@@ -24,9 +32,21 @@ int main(int argc, char** argv) {
         if (strncmp(argv[i], "-da", 3) == 0) {
             drawSolutionAfter = true;
         }
+        if (strncmp(argv[i], "-nint", 5) == 0) {
+            options.rounding = maoa::Rounding::Nint;
+        }
+        if (strcmp(argv[i], "-int") == 0) {
+            options.integerCosts = maoa::IntegerCosts::Nint;
+        }
+        if (strcmp(argv[i], "-hilbert") == 0) {
+            options.renumber = true;
+        }
+        if (strcmp(argv[i], "-best") == 0) {
+            improvement = maoa::idesc::Improvement::Best;
+        }
     }
 
-    maoa::Graph g(filepath);
+    maoa::Graph g(filepath, options);
 
     std::list<maoa::Tour> tours = maoa::bp::getFeasible(g);
     std::cout << "Number of tours constructed: " << tours.size() << std::endl;
@@ -41,7 +61,7 @@ int main(int argc, char** argv) {
         drawUtils.drawTours(tours, g);
     }
 
-    maoa::idesc::descent(tours, g);
+    maoa::idesc::descent(tours, g, improvement);
 
 //    if (tours.size() >= 10) {
 //        for (maoa::Tour &t : tours) {
@@ -0,0 +1,36 @@
+#ifndef PMAOA_COST_H
+#define PMAOA_COST_H
+
+#include "graph.h"
+
+namespace maoa {
+
+    /*!
+     * Cost policies used to instantiate the move evaluation code. A policy
+     * tells how the cost of an edge is read from the graph and when a new cost
+     * is an improvement over an old one.
+     */
+
+    /*! Floating point costs. Improvements smaller than EPSILON are ignored,
+     * so that rounding noise can not make a descent cycle. */
+    struct RealCost {
+        typedef double value_type;
+        static constexpr double EPSILON = 1e-9;
+
+        static double distance(const Graph &g, int i, int j) { return g.getDistance(i, j); }
+        static bool improves(double newCost, double oldCost) { return newCost < oldCost - EPSILON; }
+        static double toDistance(const Graph &, double cost) { return cost; }
+    };
+
+    /*! Integer costs read from Graph::intDistance. Sums are exact, so a
+     * strict comparison is enough. */
+    struct IntCost {
+        typedef long long value_type;
+
+        static long long distance(const Graph &g, int i, int j) { return g.intDistance(i, j); }
+        static bool improves(long long newCost, long long oldCost) { return newCost < oldCost; }
+        static double toDistance(const Graph &g, long long cost) { return (double) cost / g.costScale(); }
+    };
+}
+
+#endif //PMAOA_COST_H
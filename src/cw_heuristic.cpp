@@ -1,43 +1,83 @@
 #include <random>
 #include <numeric>
+#include <unordered_set>
+#include "cost.h"
 #include "cw_heuristic.h"
+#include "solution.h"
 
 namespace maoa {
     namespace cw {
 
         /*!
-         * Computes the savings list for the graph `g`. For each pair of cities (i,j), the associated saving value is
-         * the gain from including a link (i,j) to a route in a CVRP solution (s_ij = c_i0 + c0j + c_ij).
-         * @param g input graph.
-         * @return the savings list.
+         * Computes the savings of every pair of customers with the cost policy `Cost` (see cost.h).
+         */
+        template <typename Cost>
+        void _computeSavings(const Graph &g, SavingList &savings) {
+            double lambda = 1; // TODO: change this parameter
+
+            int nodeNum, i, j;
+            int depotId = g.depotId();
+            typename Cost::value_type ci0, c0j, cij;
+            nodeNum = g.nodeNum();
+            for (i = 0; i < nodeNum; i++) {
+                if (i == depotId) continue;
+                ci0 = Cost::distance(g, i, depotId);
+                // TODO: change j to i + 1
+                for (j = 0; j < nodeNum; j++) {
+                    if (i == j || j == depotId) continue;
+                    c0j = Cost::distance(g, depotId, j);
+                    cij = Cost::distance(g, i, j);
+                    savings.emplace_back(i, j, ci0 + c0j - (lambda * cij));
+                }
+            }
+        }
+
+        /*!
+         * Double costs are read row by row from the graph, which avoids a lookup per pair when the distances are
+         * cached.
          */
-        std::list<Saving> computeSavings(Graph &g) {
-            std::list<Saving> savings;
+        template <>
+        void _computeSavings<RealCost>(const Graph &g, SavingList &savings) {
             double lambda = 1; // TODO: change this parameter
 
             int nodeNum, i, j;
             int depotId = g.depotId();
             double ci0, c0j, cij;
             nodeNum = g.nodeNum();
+            const double *depotRow = g.distanceRow(depotId);
             for (i = 0; i < nodeNum; i++) {
+                const double *rowI = g.distanceRow(i);
                 // TODO: change j to i + 1
                 for (j = 0; j < nodeNum; j++) {
                     if (i == j) continue;
                     if (i == depotId || j == depotId) continue;
-                    ci0 = g.getDistance(i, depotId);
-                    c0j = g.getDistance(j, depotId);
-                    cij = g.getDistance(i, j);
+                    ci0 = rowI[depotId];
+                    c0j = depotRow[j];
+                    cij = rowI[j];
                     savings.emplace_back(i, j, ci0 + c0j - (lambda * cij));
                 }
             }
+        }
+
+        /*!
+         * Computes the savings list for the graph `g`. For each pair of cities (i,j), the associated saving value is
+         * the gain from including a link (i,j) to a route in a CVRP solution (s_ij = c_i0 + c0j + c_ij). With integer
+         * costs the savings are computed in cost units, so that equal savings compare equal.
+         * @param g input graph.
+         * @return the savings list.
+         */
+        SavingList computeSavings(Graph &g) {
+            SavingList savings;
+            if (g.hasIntegerCosts()) _computeSavings<IntCost>(g, savings);
+            else _computeSavings<RealCost>(g, savings);
             savings.sort([&](Saving &s1, Saving &s2) { return s1.saving > s2.saving; });
             return savings;
         }
 
-        std::list<Saving> _updateSavings(std::list<Saving> inSavings) {
+        SavingList _updateSavings(SavingList inSavings) {
             // IN: Must be sorted
 
-            std::list<Saving> outSavings;
+            SavingList outSavings;
 
             std::random_device rd;     // only used once to initialise (seed) engine
             std::mt19937 rng(rd());    // random-number engine used (Mersenne-Twister in this case)
@@ -79,94 +119,42 @@ namespace maoa {
             return outSavings;
         }
 
-        std::list<Tour> constructTours(Graph &g, std::list<Saving> &savings) {
+        std::list<Tour> constructTours(Graph &g, SavingList &savings) {
 
             int nodeNum, i;
             int depotId = g.depotId();
             nodeNum = g.nodeNum();
 
             // Create n initial routes of the form (depot, i, depot).
-            std::list<Tour> routes;
+            Solution routes(g);
             for (i = 0; i < nodeNum; i++) {
                 if (i == depotId) continue;
-                Tour r;
-                r.addCity(i, g.getDemand(i));
-                routes.push_back(r);
+                routes.openRoute(i);
             }
 
-            // For each saving, find two routes that can be merged.
-            auto s_it = savings.begin();
-            Tour *route1, *route2;
-            std::list<Tour>::iterator r_it;
-            int firstNode, lastNode, erase_index;
-            while (s_it != savings.end()) {
-                Saving& s = *s_it;
-                route1 = nullptr;
-                route2 = nullptr;
-
-                r_it = routes.begin();
-                i = 0;
-                erase_index = 0;
-                while (r_it != routes.end()) {
-                    // Check if there exists two routes with (i,0) and (0,j).
-                    firstNode = r_it->getFirstCity();
-                    lastNode = r_it->getLastCity();
-                    if (firstNode == s.j) {
-                        route2 = &(*r_it);
-                        erase_index = i;
-                    }
-                    if (lastNode == s.i) {
-                        route1 = &(*r_it);
-                    }
-                    r_it = std::next(r_it);
-                    i++;
-                }
-
-                if (route1 != nullptr && route2 != nullptr && route1 != route2) {
-                    if (route1->capacity + route2->capacity <= g.capacity()) {
-                        route1->merge(route2);
-
-                        // Delete empty route after merge
-                        auto re_it = routes.begin();
-                        std::advance(re_it, erase_index);
-                        routes.erase(re_it, ++re_it);
-                    }
+            // For each saving, merge the route ending with i and the route starting with j.
+            for (Saving &s : savings) {
+                if (routes.next(s.i) != depotId || routes.prev(s.j) != depotId) continue;
+                int route1 = routes.routeOf(s.i);
+                int route2 = routes.routeOf(s.j);
+                if (route1 != route2 && routes.routeLoad(route1) + routes.routeLoad(route2) <= g.capacity()) {
+                    routes.concatenate(route1, route2);
+                    MAOA_CHECK_SOLUTION(routes);
                 }
-
-                s_it++;
             }
 
-            return routes;
+            return routes.toTours();
         }
 
         /*!
-         * Returns the total distance between a string `t` of cities, with the depot of the graph `g` as starting and
-         * ending point.
-         * @param t list of consecutive cities.
-         * @param g graph containing the cities.
-         * @return the total distance as a double.
-         */
-        double getTotalTourDistance(std::list<int> &t, const Graph &g) {
-            double tourDistance = g.getDistance(g.depotId(), *t.begin());
-            auto c_it = ++t.begin();
-            while (c_it != t.end()) {
-                tourDistance += g.getDistance(*std::prev(c_it), *c_it);
-                c_it++;
-            }
-            tourDistance += g.getDistance(*--c_it, g.depotId());
-            return tourDistance;
-        }
-
-        /*!
-         * Returns the total distance of a solution.
+         * Returns the total distance of a solution from the cached tour costs.
          * @param tours list of tours
-         * @param g graph containing the tours.
          * @return the total cost of the solution (sum of tour distances) as a double.
          */
-        double getTotalCost(std::list<Tour> &tours, const Graph &g) {
+        double getTotalCost(const std::list<Tour> &tours) {
             double totalCost = 0;
-            for (Tour &t : tours) {
-                totalCost += getTotalTourDistance(t.cities, g);
+            for (const Tour &t : tours) {
+                totalCost += t.cost;
             }
             return totalCost;
         }
@@ -174,19 +162,30 @@ namespace maoa {
         std::list<Tour> getFeasible(Graph &g) {
             int nbTries = 0;
             double bestCost = INFINITY;
-            std::list<Saving> savings = computeSavings(g);
-            std::list<Saving> bestSavings;
+            SavingList savings = computeSavings(g);
+            SavingList bestSavings;
+            std::list<Tour> tours;
+            // Perturbed savings often rebuild a solution already seen, which cannot improve bestCost.
+            std::unordered_set<uint64_t> seen;
+            int duplicates = 0;
 
             while (nbTries < 1000) {
                 nbTries += 1;
-                std::list<Tour> tours = constructTours(g, savings);
+                tours = constructTours(g, savings);
                 if (tours.size() <= g.vehiclesNum()) {
-                    std::cout << "Number of tries before feasible: " << nbTries << std::endl;
+                    std::cout << "Number of tries before feasible: " << nbTries
+                              << " (" << duplicates << " duplicates)" << std::endl;
                     std::cout << "Best cost: " << bestCost << std::endl;
                     return tours;
                 }
-                double totalCost = getTotalCost(tours, g);
-                if (totalCost < bestCost) {
+                if (!seen.insert(solutionHash(tours)).second) {
+                    duplicates++;
+                    savings = _updateSavings(bestSavings);
+                    continue;
+                }
+                double totalCost = getTotalCost(tours);
+                // Costs are sums of integers with integer costs, the tolerance of RealCost is harmless.
+                if (RealCost::improves(totalCost, bestCost)) {
                     bestCost = totalCost;
                     bestSavings = savings;
                     std::cout << "Improvement: " << bestCost << std::endl;
@@ -195,7 +194,7 @@ namespace maoa {
             }
 
             std::cout << "1000 iterations and no feasible solution" << std::endl;
+            return tours;
         }
     }
 }
-
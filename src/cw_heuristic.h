@@ -11,8 +11,12 @@ namespace maoa {
             double saving;
         };
 
-        std::list<Saving> computeSavings(Graph &g);
-        std::list<Tour> constructTours(Graph & g, std::list<Saving> &savings);
+        /*! List of savings whose nodes come from the thread pool (see pool_allocator.h): the retries of
+         * getFeasible copy it over and over. */
+        typedef std::list<Saving, PoolAllocator<Saving>> SavingList;
+
+        SavingList computeSavings(Graph &g);
+        std::list<Tour> constructTours(Graph & g, SavingList &savings);
         std::list<Tour> getFeasible(Graph &g);
     }
 }
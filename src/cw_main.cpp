@@ -1,7 +1,10 @@
+#include <cstring>
+
 #include "bp_heuristic.h"
 #include "cw_heuristic.h"
 #include "draw.h"
 #include "iterative_descent.h"
+#include "solution_io.h"
 
 int main (int argc, char** argv) {
     if (argc <= 1) {
@@ -9,23 +12,69 @@ int main (int argc, char** argv) {
         std::cout << "\tcw <filepath> [options]" << std::endl;
         std::cout << "Options:" << std::endl;
         std::cout << "\t-draw, -d\t Draw final solution with gnuplot" << std::endl;
+        std::cout << "\t-nint\t Round distances to the nearest integer (TSPLIB)" << std::endl;
+        std::cout << "\t-int\t Evaluate moves with integer costs (rounded distances)" << std::endl;
+        std::cout << "\t-hilbert\t Renumber customers along a Hilbert curve" << std::endl;
+        std::cout << "\t-best\t Apply the best 2-opt move of each tour instead of the first one" << std::endl;
+        std::cout << "\t-o <file>\t Write the solution in CVRPLIB .sol format" << std::endl;
+        std::cout << "\t-ref <file>\t Compare the solution to a reference .sol file" << std::endl;
         exit(1);
     }
 
     string filepath{argv[1]};
     bool drawSolution = false;
+    string outputPath, referencePath;
+    maoa::LoadOptions options;
+    maoa::idesc::Improvement improvement = maoa::idesc::Improvement::First;
 
     for (int i = 2; i < argc; i++) {
-        if (strncmp(argv[i], "-draw", 2) == 0) {
+        if (strncmp(argv[i], "-nint", 5) == 0) {
+            options.rounding = maoa::Rounding::Nint;
+        }
+        else if (strcmp(argv[i], "-int") == 0) {
+            options.integerCosts = maoa::IntegerCosts::Nint;
+        }
+        else if (strcmp(argv[i], "-hilbert") == 0) {
+            options.renumber = true;
+        }
+        else if (strcmp(argv[i], "-best") == 0) {
+            improvement = maoa::idesc::Improvement::Best;
+        }
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "-ref") == 0 && i + 1 < argc) {
+            referencePath = argv[++i];
+        }
+        else if (strncmp(argv[i], "-draw", 2) == 0) {
             drawSolution = true;
         }
     }
 
-    maoa::Graph g(filepath);
+    maoa::Graph g(filepath, options);
 
     std::list<maoa::Tour> tours = maoa::cw::getFeasible(g);
     std::cout << "Number of routes: " << tours.size() << std::endl;
-    maoa::idesc::descent(tours, g);
+    maoa::idesc::descent(tours, g, improvement);
+
+    double cost = 0;
+    maoa::sol::ValidationStatus status = maoa::sol::validate(g, tours, &cost);
+    std::cout << "Solution is " << maoa::sol::validationStatusMessage(status) << ", cost " << cost << std::endl;
+    if (!referencePath.empty()) {
+        std::list<maoa::Tour> reference;
+        double referenceCost;
+        maoa::ParseStatus parsed = maoa::sol::read(g, referencePath, reference, &referenceCost);
+        if (parsed != maoa::ParseStatus::Ok) {
+            std::cerr << "Cannot read " << referencePath << ": " << maoa::parseStatusMessage(parsed) << std::endl;
+        } else {
+            if (referenceCost < 0) maoa::sol::validate(g, reference, &referenceCost);
+            std::cout << "Reference cost " << referenceCost << ", gap "
+                      << 100 * (cost - referenceCost) / referenceCost << "%" << std::endl;
+        }
+    }
+    if (!outputPath.empty() && !maoa::sol::write(g, tours, outputPath)) {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+    }
 
     if (drawSolution) {
         maoa::DrawUtils drawUtils;
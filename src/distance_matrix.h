@@ -0,0 +1,92 @@
+#ifndef PMAOA_DISTANCE_MATRIX_H
+#define PMAOA_DISTANCE_MATRIX_H
+
+#include <cstdlib>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+namespace maoa {
+
+    /*!
+     * Dense square matrix stored in one contiguous buffer. Every row is padded
+     * to a whole number of cache lines and starts on a cache line boundary, so
+     * that scanning a row touches the minimum number of lines.
+     */
+    template <typename T>
+    class DistanceMatrix {
+    public:
+        /*! Size in bytes of a cache line, used for alignment and padding. */
+        static constexpr std::size_t CACHE_LINE = 64;
+
+        DistanceMatrix() : _data(nullptr), _n(0), _stride(0) {}
+
+        /*!
+         * Wraps existing storage, e.g. a memory-mapped file. The matrix keeps
+         * \a storage alive but never writes to it when only read through the
+         * const accessors.
+         * @param storage First element of row 0, aligned on a cache line.
+         * @param n Number of rows (and columns).
+         * @param stride Distance in elements between two consecutive rows.
+         */
+        DistanceMatrix(std::shared_ptr<T> storage, int n, std::size_t stride)
+                : _storage(std::move(storage)), _n(n), _stride(stride) {
+            _data = _storage.get();
+        }
+
+        /*!
+         * Allocates an uninitialized \a n x \a n matrix. Any previous content
+         * is released. Copies of a matrix share the same storage.
+         * @param n Number of rows (and columns).
+         */
+        void resize(int n) {
+            if (n <= 0) {
+                clear();
+                return;
+            }
+            _n = n;
+            _stride = strideFor(n);
+            void *ptr = nullptr;
+            if (posix_memalign(&ptr, CACHE_LINE, _stride * n * sizeof(T)) != 0) {
+                throw std::bad_alloc();
+            }
+            _storage.reset(static_cast<T *>(ptr), [](T *p) { std::free(p); });
+            _data = _storage.get();
+        }
+
+        /*! Row stride used for a matrix of \a n columns. */
+        static std::size_t strideFor(int n) {
+            const std::size_t perLine = CACHE_LINE / sizeof(T);
+            return ((std::size_t) n + perLine - 1) / perLine * perLine;
+        }
+
+        /*! Releases the storage. */
+        void clear() {
+            _storage.reset();
+            _data = nullptr;
+            _n = 0;
+            _stride = 0;
+        }
+
+        T operator()(int i, int j) const { return _data[i * _stride + j]; }
+        T &at(int i, int j) { return _data[i * _stride + j]; }
+
+        /*! Returns a pointer to the first element of row \a i. */
+        const T *row(int i) const { return _data + i * _stride; }
+        T *row(int i) { return _data + i * _stride; }
+
+        /*! Number of rows (and columns) of the matrix. */
+        int size() const { return _n; }
+        /*! Distance in elements between the starts of two consecutive rows. */
+        std::size_t stride() const { return _stride; }
+        bool empty() const { return _data == nullptr; }
+
+    private:
+        std::shared_ptr<T> _storage;
+        T *_data;
+        int _n;
+        std::size_t _stride;
+    };
+}
+
+#endif //PMAOA_DISTANCE_MATRIX_H
@@ -1,88 +1,180 @@
+#include <algorithm>
 #include <cstring>
-#include <sstream>
-#include <fstream>
 #include <iostream>
-#include <regex>
 
 #include "graph.h"
+#include "metric.h"
+#include "snapshot.h"
 
 using std::string;
 using namespace maoa;
-using Node = lemon::FullGraph::Node;
-using NodeMap = lemon::FullGraph::NodeMap<NodeData>;
 
-Graph::Graph(const string &filename) : _nodeMap(*this) {
+Graph::Graph(const string &filename, const LoadOptions &options)
+        : Graph(_parseOrExit(filename), options) {}
 
-    std::ifstream infile;
-    infile.open(filename);
+Graph::Graph(const InstanceData &data, const LoadOptions &options) {
+    const int nodeNum = data.dimension;
+    this->resize(nodeNum);
+    _x.resize(nodeNum);
+    _y.resize(nodeNum);
+    _demand.resize(nodeNum);
+    _depotId = data.depotId;
+    // Explicit instances have no geometry to follow, and the matrix is shared.
+    if (options.renumber && data.edgeWeightType != EdgeWeightType::Explicit) {
+        hilbertOrder(data.x.data(), data.y.data(), nodeNum, data.depotId, _originalIds);
+        _internalIds.resize(nodeNum);
+        for (int i = 0; i < nodeNum; i++) {
+            const int original = _originalIds[i];
+            _internalIds[original] = i;
+            _x[i] = data.x[original];
+            _y[i] = data.y[original];
+            _demand[i] = data.demand[original];
+        }
+        _depotId = 0;
+    } else {
+        memcpy(_x.data(), data.x.data(), nodeNum * sizeof(float));
+        memcpy(_y.data(), data.y.data(), nodeNum * sizeof(float));
+        memcpy(_demand.data(), data.demand.data(), nodeNum * sizeof(float));
+    }
+    _Q = data.capacity;
+    _vehicles = data.vehicles;
 
-    if (!infile) {
-        std::cerr << "Unable to open file : " << filename << std::endl;
-        exit(1);
+    _edgeWeightType = data.edgeWeightType;
+    _rounding = options.rounding;
+    if (data.edgeWeightType == EdgeWeightType::Explicit) {
+        _rounding = Rounding::None;
+    } else if (_rounding == Rounding::Default) {
+        _rounding = data.edgeWeightType == EdgeWeightType::Ceil2D ? Rounding::Ceil : Rounding::None;
     }
 
-    string line;
-    string data[3];
-    int i;
+    // Fixed seed: hashes of the same instance are comparable across runs.
+    _nodeKeys.resize(nodeNum);
+    uint64_t seed = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < nodeNum; i++) {
+        seed += 0x9e3779b97f4a7c15ULL;
+        _nodeKeys[i] = zobrist::mix(seed) | 1;
+    }
 
-    bool readingCoord = false;
-    bool readingDemand = false;
-    bool readingDepot = false;
+    _selectRowKernel();
+    _buildDistanceMatrix(data, options);
+    buildNeighbors(options.neighbors);
+}
 
-    while (getline(infile, line)) {
-        if (line.find("NODE_COORD_SECTION") != string::npos) {
-            readingCoord = true;
-        }
-        else if (line.find("DEMAND_SECTION") != string::npos) {
-            readingCoord = false;
-            readingDemand = true;
-        }
-        else if (line.find("DEPOT_SECTION") != string::npos) {
-            readingDemand = false;
-            readingDepot = true;
-        }
-        else if(line.find("VEHICLES") != string::npos
-                or line.find("trucks") != string::npos){
-            std::regex r ("[[:digit:]]+");
-            std::smatch s;
-            std::regex_search(line,s,r);
-            _vehicles = stoi(s[0]);
+void Graph::buildNeighbors(int k) {
+    const int nodeNum = this->nodeNum();
+    _k = std::max(0, std::min(k, nodeNum - 2));
+    if (_edgeWeightType == EdgeWeightType::Explicit) {
+        if (hasIntegerCosts()) buildNeighborLists(_intDistances, _depotId, _k, _neighbors);
+        else buildNeighborLists(_distances, _depotId, _k, _neighbors);
+    } else if (_edgeWeightType == EdgeWeightType::Man2D || _edgeWeightType == EdgeWeightType::Geo) {
+        buildNeighborLists(nodeNum, _depotId, _k, [this](int i) { return distanceRow(i); }, _neighbors);
+    } else {
+        // ATT is a monotone function of the euclidean distance.
+        buildNeighborLists(_x.data(), _y.data(), nodeNum, _depotId, _k, _neighbors);
+    }
+}
 
-        }
-        else {
-            // Extract data from the line. There is at most three strings that
-            // matter to us for each line.
-            std::stringstream lineStream(line);
-            string temp;
-            i = 0;
-            while (!lineStream.eof() && i < 3) {
-                lineStream >> data[i];
-                i++;
-            }
-            if (data[0] == "DIMENSION") {
-                this->resize(stoi(data[2]));
-                continue;
-            }
-            if (data[0] == "CAPACITY") {
-                _Q = stof(data[2]);
-                continue;
-            }
-            if (readingCoord) {
-                // Add Node to graph.
-                int nodeIndex = stoi(data[0]) - 1;
-                Node u = this->operator()(nodeIndex);
-                _nodeMap[u].x = stof(data[1]);
-                _nodeMap[u].y = stof(data[2]);
-            }
-            else if (readingDemand) {
-                Node u = this->operator()(stoi(data[0]) - 1);
-                _nodeMap[u].demand = stof(data[1]);
-            }
-            else if (readingDepot) {
-                _depotId = stoi(data[0]) - 1;
-                break;
+InstanceData Graph::_parseOrExit(const string &filename) {
+    InstanceData data;
+    ParseStatus status = snapshot::isSnapshot(filename) ? snapshot::load(filename, data)
+                                                        : parseVrpFile(filename, data);
+    if (status != ParseStatus::Ok) {
+        std::cerr << "Unable to load file : " << filename << " ("
+                  << parseStatusMessage(status) << ")" << std::endl;
+        exit(1);
+    }
+    return data;
+}
+
+void Graph::_buildDistanceMatrix(const InstanceData &data, const LoadOptions &options) {
+    const int nodeNum = this->nodeNum();
+    const std::size_t stride = DistanceMatrix<double>::strideFor(nodeNum);
+    const std::size_t rowBytes = stride * sizeof(double);
+    // Filled by the parser or mapped from a snapshot, in file order.
+    const bool shared = data.edgeWeightType == EdgeWeightType::Explicit
+                        || (!data.distances.empty() && data.distancesRounding == _rounding && !isRenumbered());
+
+    _costScale = options.integerCosts == IntegerCosts::FixedPoint ? options.costScale : 1;
+    _unitCost = 1.0 / _costScale;
+
+    if (options.integerCosts != IntegerCosts::None) {
+        _intDistances.resize(nodeNum);
+        AlignedArray<double> buffer(stride);
+        for (int i = 0; i < nodeNum; i++) {
+            const double *row = buffer.data();
+            if (shared) row = data.distances.row(i);
+            else _computeDistanceRow(i, buffer.data());
+            int32_t *intRow = _intDistances.row(i);
+            for (int j = 0; j < nodeNum; j++) {
+                intRow[j] = (int32_t) std::floor(row[j] * _costScale + 0.5);
             }
         }
+        // Only a few double rows are needed by distanceRow callers, they are
+        // converted from the integer matrix on demand.
+        const std::size_t convertedRows = 64;
+        _setupRowCache(std::min(options.memoryBudget, convertedRows * rowBytes), [this](int i, double *row) {
+            const int32_t *intRow = _intDistances.row(i);
+            for (int j = 0; j < this->nodeNum(); j++) row[j] = intRow[j] * _unitCost;
+        });
+        return;
+    }
+
+    if (shared) {
+        _distances = data.distances;
+        return;
+    }
+
+    bool cached = options.storage == DistanceStorage::Cached
+                  || (options.storage == DistanceStorage::Auto && rowBytes * nodeNum > options.memoryBudget);
+    if (cached) {
+        _setupRowCache(options.memoryBudget, [this](int i, double *row) {
+            _computeDistanceRow(i, row);
+        });
+        return;
+    }
+
+    _distances.resize(nodeNum);
+    // Whole rows are computed rather than mirroring the upper triangle: the
+    // writes stay sequential and the result is symmetric anyway.
+    for (int i = 0; i < nodeNum; i++) {
+        _computeDistanceRow(i, _distances.row(i));
+    }
+}
+
+void Graph::_setupRowCache(std::size_t memoryBudget, DistanceRowCache::RowFunction computeRow) {
+    const int nodeNum = this->nodeNum();
+    const std::size_t stride = DistanceMatrix<double>::strideFor(nodeNum);
+    _depotRow.resize(stride);
+    computeRow(_depotId, _depotRow.data());
+    std::size_t rows = memoryBudget / (stride * sizeof(double));
+    rows = std::max<std::size_t>(2, std::min<std::size_t>(rows, nodeNum));
+    _cache.reset(nodeNum, stride, (int) rows, std::move(computeRow));
+}
+
+void Graph::_selectRowKernel() {
+    switch (_edgeWeightType) {
+        case EdgeWeightType::Att: _rowKernel = &Graph::_computeDistanceRowWith<metric::Att>; break;
+        case EdgeWeightType::Geo: _rowKernel = &Graph::_computeDistanceRowWith<metric::Geo>; break;
+        case EdgeWeightType::Man2D: _rowKernel = &Graph::_computeDistanceRowWith<metric::Manhattan>; break;
+        // Explicit instances never compute rows, their matrix is shared.
+        default: _rowKernel = &Graph::_computeDistanceRowWith<metric::Euclidean>; break;
+    }
+}
+
+template <typename Metric>
+void Graph::_computeDistanceRowWith(int i, double *row) const {
+    const int nodeNum = this->nodeNum();
+    const float *x = _x.data();
+    const float *y = _y.data();
+    const double xi = x[i], yi = y[i];
+    for (int j = 0; j < nodeNum; j++) {
+        row[j] = Metric::distance(xi, yi, x[j], y[j]);
+    }
+    row[i] = 0;
+    if (_rounding == Rounding::Nint) {
+        for (int j = 0; j < nodeNum; j++) row[j] = std::floor(row[j] + 0.5);
+    } else if (_rounding == Rounding::Ceil) {
+        for (int j = 0; j < nodeNum; j++) row[j] = std::ceil(row[j]);
     }
 }
 
@@ -90,9 +182,8 @@ void Graph::print() const {
     const int nodeNum = this->nodeNum();
     int i;
     for (i = 0; i < nodeNum; i++) {
-        Node u = this->operator()(i);
-        std::cout << _nodeMap[u].to_string() << std::endl;
+        std::cout << getData(internalId(i)).to_string() << std::endl;
     }
-    std::cout << "Depot: " << depotId() << std::endl;
+    std::cout << "Depot: " << originalId(depotId()) << std::endl;
     std::cout << "Capacity: " << _Q << std::endl;
 }
\ No newline at end of file
@@ -2,7 +2,22 @@
 #define UTILS_H
 
 #include <lemon/full_graph.h>
+#include <algorithm>
+#include <cassert>
 #include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <sstream>
+
+#include "aligned_array.h"
+#include "distance_matrix.h"
+#include "neighbor_lists.h"
+#include "pool_allocator.h"
+#include "renumbering.h"
+#include "row_cache.h"
+#include "vrp_parser.h"
+#include "zobrist.h"
 
 using std::string;
 
@@ -18,56 +33,242 @@ namespace maoa {
 		}
 	};
 
+	/*! Where the distances of coordinate based instances are kept. */
+	enum class DistanceStorage {
+	    Auto,   //!< Dense if the matrix fits in LoadOptions::memoryBudget, Cached otherwise.
+	    Dense,  //!< Full matrix computed at load.
+	    Cached  //!< Rows computed on demand, LRU cache of LoadOptions::memoryBudget bytes.
+	};
+
+	/*! Integer cost mode, see Graph::intDistance. */
+	enum class IntegerCosts {
+	    None,      //!< Distances are only kept as doubles.
+	    Nint,      //!< Distances rounded to the nearest integer.
+	    FixedPoint //!< Distances multiplied by LoadOptions::costScale, then rounded.
+	};
+
+	/*! Options controlling how an instance is turned into a Graph. */
+	struct LoadOptions {
+	    Rounding rounding = Rounding::Default;
+	    DistanceStorage storage = DistanceStorage::Auto;
+	    /*! Memory allowed for distances, in bytes. */
+	    std::size_t memoryBudget = (std::size_t) 1 << 30;
+	    /*! With integer costs, distances are stored once in an int32 matrix
+	     * (half the size of the double one) and \p storage is ignored. */
+	    IntegerCosts integerCosts = IntegerCosts::None;
+	    /*! Number of cost units per distance unit with IntegerCosts::FixedPoint.
+	     * Scaled distances must fit in an int32. */
+	    int costScale = 1000;
+	    /*! Size of the candidate lists built at load, see Graph::neighbors.
+	     * Clamped to the number of customers minus one, 0 disables them. */
+	    int neighbors = 30;
+	    /*! Renumber the customers along a Hilbert curve for better memory
+	     * locality, see Graph::originalId. Ignored by explicit instances. */
+	    bool renumber = false;
+	};
+
 	class Graph : public lemon::FullGraph{
 	public:
-        explicit Graph(const string & filename);
+        /*!
+         * Loads a CVRPLIB instance, or a binary snapshot if the file has the
+         * snapshot extension (see snapshot.h). Exits the program if the file
+         * cannot be parsed; batch drivers that need to skip bad files should
+         * call \p parseVrpFile themselves and use the other constructor.
+         * @param filename Path of the instance file.
+         * @param options Load options.
+         */
+        explicit Graph(const string & filename, const LoadOptions &options = LoadOptions());
+        /*!
+         * Builds the graph from an already parsed instance. Distances carried
+         * by \a data (explicit weights, or a snapshot matrix computed with the
+         * same rounding) are shared, not copied.
+         * @param data Parsed instance.
+         * @param options Load options.
+         */
+        explicit Graph(const InstanceData &data, const LoadOptions &options = LoadOptions());
+
+        /*!
+         * With LoadOptions::renumber, node ids are internal: the depot is
+         * node 0 and customers follow a Hilbert curve. These functions
+         * translate between internal ids and the ids of the instance file
+         * (0-based), which are the ones every output must show. Without
+         * renumbering both are the identity.
+         */
+        int originalId(int i) const { return _originalIds.empty() ? i : _originalIds[i]; }
+        int internalId(int original) const { return _internalIds.empty() ? original : _internalIds[original]; }
+        bool isRenumbered() const { return !_originalIds.empty(); }
 
 		double getDistance(const lemon::FullGraph::Node &v1, const lemon::FullGraph::Node &v2) const {
-            NodeData d1 = _nodeMap[v1];
-            NodeData d2 = _nodeMap[v2];
-            return _eucDist(d1, d2);
+            return getDistance(this->id(v1), this->id(v2));
         }
         double getDistance(int n1, int n2) const {
-            return getDistance(this->operator()(n1), this->operator()(n2));
+            if (!_distances.empty()) return _distances(n1, n2);
+            if (!_intDistances.empty()) return _intDistances(n1, n2) * _unitCost;
+            return _cachedDistance(n1, n2);
 		}
+        /*!
+         * Returns the distance between \a n1 and \a n2 in integer cost units:
+         * the stored value with integer costs, the distance rounded to the
+         * nearest integer otherwise. Sums and differences of these values are
+         * exact, which is what move evaluation should use with integer costs.
+         */
+        int32_t intDistance(int n1, int n2) const {
+            if (!_intDistances.empty()) return _intDistances(n1, n2);
+            return (int32_t) std::floor(getDistance(n1, n2) + 0.5);
+        }
+        /*! True if the graph was loaded with integer costs. */
+        bool hasIntegerCosts() const { return !_intDistances.empty(); }
+        /*! Number of integer cost units per distance unit. */
+        int costScale() const { return _costScale; }
+        /*!
+         * Returns a pointer to the distances from node \a n1 to every node of
+         * the graph, indexed by node id. With cached distances (or integer
+         * costs, whose rows are converted on demand) the pointer is only
+         * guaranteed until the next getDistance or distanceRow call that
+         * misses the cache, except for the depot row which is always kept.
+         */
+        const double *distanceRow(int n1) const {
+            if (!_distances.empty()) return _distances.row(n1);
+            return n1 == _depotId ? _depotRow.data() : _cache.row(n1);
+        }
+        /*! True if every distance is precomputed, false if rows are cached. */
+        bool hasDenseDistances() const { return !_distances.empty(); }
+        /*! Hit and miss counters of the row cache, zero with dense distances. */
+        const RowCacheStats &distanceCacheStats() const { return _cache.stats(); }
         void print() const;
 		int vehiclesNum() const { return _vehicles;	}
 		float capacity() const { return _Q; }
 		int depotId() const { return _depotId; }
+		/*! Rounding used for coordinate based distances. Always
+		 * Rounding::None for explicit instances. */
+		Rounding rounding() const { return _rounding; }
+		EdgeWeightType edgeWeightType() const { return _edgeWeightType; }
+		/*! Precomputed distances between every pair of nodes, empty when
+		 * distances are cached. */
+		const DistanceMatrix<double> &distanceMatrix() const { return _distances; }
 		float getDemand(lemon::FullGraph::Node u) const {
-		    return _nodeMap[u].demand;
+		    return getDemand(this->id(u));
 		}
 		float getDemand(int i) const {
-		    return getDemand(this->operator()(i));
+		    return _demand[i];
 		}
 		NodeData getData(lemon::FullGraph::Node u) const {
-		    return _nodeMap[u];
+		    return getData(this->id(u));
 		}
 		NodeData getData(int nodeId) const {
-		    lemon::FullGraph::Node u = this->operator()(nodeId);
-		    return getData(u);
+		    return NodeData{_x[nodeId], _y[nodeId], _demand[nodeId]};
 		}
 
+		/*!
+		 * Node data stored as structure of arrays, indexed by node id. Each
+		 * array is aligned on a cache line and holds nodeNum() elements.
+		 */
+		const float *xs() const { return _x.data(); }
+		const float *ys() const { return _y.data(); }
+		const float *demands() const { return _demand.data(); }
+
+		/*!
+		 * Returns the neighborCount() customers closest to node \a i, by
+		 * increasing distance. Neither the depot nor \a i belong to the list.
+		 */
+		const int *neighbors(int i) const { return _neighbors.data() + (size_t) i * _k; }
+		/*! Number of entries of every candidate list. */
+		int neighborCount() const { return _k; }
+		/*! All candidate lists in one flat array of nodeNum()*neighborCount() ids. */
+		const int *neighborLists() const { return _neighbors.data(); }
+		/*!
+		 * Key of the edge between \a u and \a v for route hashing, see
+		 * zobrist.h. Symmetric, and fixed for a given instance.
+		 */
+		uint64_t edgeKey(int u, int v) const { return zobrist::mix(_nodeKeys[u] * _nodeKeys[v]); }
+
+		/*!
+		 * Rebuilds the candidate lists with \a k neighbors per node.
+		 * @param k Requested size, clamped to the number of customers minus one.
+		 */
+		void buildNeighbors(int k);
+
 	private:
-		lemon::FullGraph::NodeMap<NodeData> _nodeMap;
+		AlignedArray<float> _x, _y, _demand;
 		int _depotId;
 		float _Q;
 		int _vehicles;
+		Rounding _rounding;
+		EdgeWeightType _edgeWeightType;
+		DistanceMatrix<double> _distances;
+		DistanceMatrix<int32_t> _intDistances;
+		int _costScale;
+		double _unitCost; // 1 / _costScale
+		// Cached mode: the depot row is permanent, the others go through the cache.
+		AlignedArray<double> _depotRow;
+		mutable DistanceRowCache _cache;
+		std::vector<int> _neighbors;
+		int _k;
+		// Odd random keys, indexed by internal id.
+		AlignedArray<uint64_t> _nodeKeys;
+		// Empty unless renumbered: internal id -> file id, and the reverse.
+		std::vector<int> _originalIds, _internalIds;
+
+		// Distance kernel of the instance metric, selected once at load.
+		void (Graph::*_rowKernel)(int i, double *row) const;
 
-		double _eucDist(NodeData &d1, NodeData &d2) const {
-		    return sqrt(pow(d1.x - d2.x, 2) + pow(d1.y - d2.y, 2));
+		void _computeDistanceRow(int i, double *row) const { (this->*_rowKernel)(i, row); }
+		template <typename Metric>
+		void _computeDistanceRowWith(int i, double *row) const;
+		void _selectRowKernel();
+		void _buildDistanceMatrix(const InstanceData &data, const LoadOptions &options);
+		void _setupRowCache(std::size_t memoryBudget, DistanceRowCache::RowFunction computeRow);
+		double _cachedDistance(int n1, int n2) const {
+		    if (n1 == _depotId) return _depotRow[n2];
+		    if (n2 == _depotId) return _depotRow[n1];
+		    // Distances are symmetric, use whichever row is already there.
+		    if (_cache.peek(n1) == nullptr && _cache.peek(n2) != nullptr) return _cache.row(n2)[n1];
+		    return _cache.row(n1)[n2];
 		}
+		static InstanceData _parseOrExit(const string &filename);
 	};
 
+	/*!
+	 * Debug check of the cached tour costs, compiled in with the
+	 * MAOA_DEBUG_CHECKS CMake option. Every procedure that updates
+	 * Tour::cost and Tour::hash by delta checks the tours it changed against
+	 * a full recomputation.
+	 */
+#ifdef MAOA_DEBUG_CHECKS
+#define MAOA_CHECK_TOUR_COST(t, g) assert((t).hasValidCost(g) && (t).hash == (t).computeHash(g))
+#else
+#define MAOA_CHECK_TOUR_COST(t, g) ((void) 0)
+#endif
+
 	struct Tour {
 		float capacity;
-		std::list<int> cities;
+		CityList cities;
+		/*! Length of the tour, depot included at both ends. Kept up to date
+		 * by the overloads taking a Graph and by the improvement procedures,
+		 * the others leave it to the caller (see computeCost). */
+		double cost;
+		/*! Direction independent hash of the tour (see zobrist.h), 0 when
+		 * empty. Maintained like \p cost. */
+		uint64_t hash;
 
-		Tour() : capacity(0) {}
+		Tour() : capacity(0), cost(0), hash(0) {}
 		void addCity(int i, float c) {
 			cities.push_back(i);
 			capacity += c;
 		}
+		/*! Appends city \a i and updates the cost and hash. */
+		void addCity(int i, float c, const Graph &g) {
+			const int depotId = g.depotId();
+			if (cities.empty()) {
+				cost = g.getDistance(depotId, i) + g.getDistance(i, depotId);
+				hash = 2 * g.edgeKey(depotId, i);
+			} else {
+				const int last = getLastCity();
+				cost += g.getDistance(last, i) + g.getDistance(i, depotId) - g.getDistance(last, depotId);
+				hash += g.edgeKey(last, i) + g.edgeKey(i, depotId) - g.edgeKey(last, depotId);
+			}
+			addCity(i, c);
+		}
 		int getFirstCity() const {
 			return *cities.begin();
 		}
@@ -82,11 +283,75 @@ namespace maoa {
 			}
 			std::cout << "0" << std::endl;
 		}
+		/*! Same as print(), with the ids of the instance file of \a g. */
+		void print(const Graph &g) const {
+			std::cout << "Capacity: " << capacity << std::endl;
+			std::cout << g.originalId(g.depotId()) << " ";
+			for (int a : cities) {
+				std::cout << g.originalId(a) << " ";
+			}
+			std::cout << g.originalId(g.depotId()) << std::endl;
+		}
 		void merge(Tour * t2) {
 			cities.splice(cities.end(), t2->cities);
 			capacity += t2->capacity;
 		}
+		/*! Appends the cities of \a t2 and updates the cost and hash: the
+		 * edges (last, depot) and (depot, first of t2) become (last, first of t2). */
+		void merge(Tour * t2, const Graph &g) {
+			cost += t2->cost;
+			hash += t2->hash;
+			if (!cities.empty() && !t2->cities.empty()) {
+				const int depotId = g.depotId();
+				const int last = getLastCity(), first = t2->getFirstCity();
+				cost += g.getDistance(last, first) - g.getDistance(last, depotId) - g.getDistance(depotId, first);
+				hash += g.edgeKey(last, first) - g.edgeKey(last, depotId) - g.edgeKey(depotId, first);
+			}
+			merge(t2);
+		}
+		/*! Recomputes the cost from scratch. */
+		double computeCost(const Graph &g) const {
+			if (cities.empty()) return 0;
+			double total = 0;
+			int prev = g.depotId();
+			for (int a : cities) {
+				total += g.getDistance(prev, a);
+				prev = a;
+			}
+			return total + g.getDistance(prev, g.depotId());
+		}
+		void updateCost(const Graph &g) { cost = computeCost(g); }
+		/*! Recomputes the hash from scratch. */
+		uint64_t computeHash(const Graph &g) const {
+			if (cities.empty()) return 0;
+			uint64_t total = 0;
+			int prev = g.depotId();
+			for (int a : cities) {
+				total += g.edgeKey(prev, a);
+				prev = a;
+			}
+			return total + g.edgeKey(prev, g.depotId());
+		}
+		void updateHash(const Graph &g) { hash = computeHash(g); }
+		/*! True if the cached cost matches a full recomputation. */
+		bool hasValidCost(const Graph &g, double tolerance = 1e-6) const {
+			const double actual = computeCost(g);
+			return std::fabs(cost - actual) <= tolerance * std::max(1.0, std::fabs(actual));
+		}
 	};
+
+	/*!
+	 * Returns the hash of a solution from the cached hash of its tours, in
+	 * O(number of tours). It does not depend on the order of the tours nor on
+	 * their direction.
+	 */
+	inline uint64_t solutionHash(const std::list<Tour> &tours) {
+		uint64_t total = 0;
+		for (const Tour &t : tours) {
+			total += zobrist::routeContribution(t.hash);
+		}
+		return total;
+	}
 }
 
 #endif
\ No newline at end of file
@@ -1,225 +1,749 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "cost.h"
 #include "iterative_descent.h"
+#include "route.h"
+#include "solution.h"
+#include "two_level_route.h"
 
 namespace maoa {
 namespace idesc {
 
-    double getTotalTourDistance(std::list<int> &t, const Graph &g) {
-        double tourDistance = g.getDistance(g.depotId(), *t.begin());
+namespace {
+
+    /*
+     * The procedures are written once for a cost policy (see cost.h) and
+     * instantiated for double and integer costs. The public functions choose
+     * the instantiation from the way the graph was loaded.
+     */
+
+    template <typename Cost>
+    typename Cost::value_type tourCost(const CityList &t, const Graph &g) {
+        if (t.empty()) return 0;
+        typename Cost::value_type tourDistance = Cost::distance(g, g.depotId(), *t.begin());
         auto c_it = ++t.begin();
         while (c_it != t.end()) {
-            tourDistance += g.getDistance(*std::prev(c_it), *c_it);
+            tourDistance += Cost::distance(g, *std::prev(c_it), *c_it);
             c_it++;
         }
-        tourDistance += g.getDistance(*--c_it, g.depotId());
+        tourDistance += Cost::distance(g, *--c_it, g.depotId());
         return tourDistance;
     }
 
-    double getTotalCost(std::list<Tour> &tours, const Graph &g) {
-        double totalCost = 0;
-        for (Tour &t : tours) {
-            totalCost += getTotalTourDistance(t.cities, g);
-        }
-        return totalCost;
-    }
-
-    bool improve2opt(std::list<Tour> &tours, const Graph &g) {
+    /*
+     * 2-opt on a single tour held in `route`, a Route or a TwoLevelRoute: both
+     * have the same navigation interface. The cost and hash deltas of the
+     * moves are added to `delta` and `hashDelta`.
+     *
+     * Reversing the cities from b to c replaces the edges (a, b) and (c, d)
+     * by (a, c) and (b, d). Distances are symmetric, so the cost of the
+     * reversed segment is unchanged and a move is evaluated in O(1).
+     */
+    template <typename Cost, typename RouteType>
+    bool improve2opt(RouteType &route, const Graph &g, Improvement mode,
+                     typename Cost::value_type &delta, uint64_t &hashDelta) {
+        typedef typename Cost::value_type value_type;
+        const int depotId = g.depotId();
         bool changeMade = false;
 
-        int firstNodeIdx, secondNodeIdx;
-        long t_size;
-
-        for (Tour &t : tours) {
-            t_size = t.cities.size();
-            // Compute original tour cost (before improvements).
-            double currentTourCost = getTotalTourDistance(t.cities, g);
-            double newTourCost;
-            std::list<int>::iterator c_it;
-
-            firstNodeIdx = -1;
-            while (firstNodeIdx < t_size - 1) {
-
-                secondNodeIdx = firstNodeIdx + 1;
-                while (secondNodeIdx < t_size) {
-
-                    // Construct new tour according to firstNode and secondNode.
-                    std::list<int> new_tour;
-                    // 1. Append every node before `firstNode`.
-                    int constructIdx;
-                    c_it = t.cities.begin();
-                    for (constructIdx = 0; constructIdx <= firstNodeIdx; constructIdx++) {
-                        new_tour.push_back(*c_it);
-                        c_it++;
-                    }
-                    // 2. Add from `secondNode` to `firstNode` in reverse order
-                    int advanceCounter = (firstNodeIdx == -1) ? secondNodeIdx : secondNodeIdx-firstNodeIdx-1;
-                    std::advance(c_it, advanceCounter);
-                    for (constructIdx = secondNodeIdx; constructIdx > firstNodeIdx; constructIdx--) {
-                        new_tour.push_back(*c_it);
-                        c_it--;
+        if (mode == Improvement::First) {
+            bool improved;
+            do {
+                improved = false;
+                int b = route.first();
+                while (b >= 0 && route.next(b) >= 0) {
+                    const int a = (route.prev(b) >= 0) ? route.prev(b) : depotId;
+                    int moved = -1;
+                    for (int c = route.next(b); c >= 0; c = route.next(c)) {
+                        const int d = (route.next(c) >= 0) ? route.next(c) : depotId;
+                        value_type currentDistance = Cost::distance(g, a, b) + Cost::distance(g, c, d);
+                        value_type distanceIfReversed = Cost::distance(g, a, c) + Cost::distance(g, b, d);
+                        if (Cost::improves(distanceIfReversed, currentDistance)) {
+                            route.reversePath(b, c);
+                            delta += distanceIfReversed - currentDistance;
+                            hashDelta += g.edgeKey(a, c) + g.edgeKey(b, d) - g.edgeKey(a, b) - g.edgeKey(c, d);
+                            moved = c;
+                            break;
+                        }
                     }
-                    // 3. Add rest of route in correct order.
-                    std::advance(c_it, secondNodeIdx-firstNodeIdx+1);
-                    for (constructIdx = secondNodeIdx + 1; constructIdx < t_size; constructIdx++) {
-                        new_tour.push_back(*c_it);
-                        c_it++;
+                    // After a move, go on from the city that took the place of b.
+                    if (moved >= 0) {
+                        b = moved;
+                        improved = changeMade = true;
+                    } else {
+                        b = route.next(b);
                     }
+                }
+            } while (improved);
+            return changeMade;
+        }
 
-                    newTourCost = getTotalTourDistance(new_tour, g);
-                    if (newTourCost < currentTourCost) {
-                        changeMade = true;
-                        currentTourCost = newTourCost;
-                        t.cities.swap(new_tour);
-                        firstNodeIdx = -1;
-                        secondNodeIdx = 0;
-                    } else {
-                        secondNodeIdx++;
+        for (;;) {
+            value_type bestDelta = 0;
+            int bestA = -1, bestB = -1, bestC = -1, bestD = -1;
+            for (int b = route.first(); b >= 0 && route.next(b) >= 0; b = route.next(b)) {
+                const int a = (route.prev(b) >= 0) ? route.prev(b) : depotId;
+                for (int c = route.next(b); c >= 0; c = route.next(c)) {
+                    const int d = (route.next(c) >= 0) ? route.next(c) : depotId;
+                    value_type moveDelta = Cost::distance(g, a, c) + Cost::distance(g, b, d)
+                                           - Cost::distance(g, a, b) - Cost::distance(g, c, d);
+                    if (Cost::improves(moveDelta, bestDelta)) {
+                        bestDelta = moveDelta;
+                        bestA = a, bestB = b, bestC = c, bestD = d;
                     }
                 }
-                firstNodeIdx++;
+            }
+            if (bestB < 0) return changeMade;
+            route.reversePath(bestB, bestC);
+            delta += bestDelta;
+            hashDelta += g.edgeKey(bestA, bestC) + g.edgeKey(bestB, bestD)
+                         - g.edgeKey(bestA, bestB) - g.edgeKey(bestC, bestD);
+            changeMade = true;
+        }
+    }
+
+    template <typename Cost>
+    bool improve2opt(std::list<Tour> &tours, const Graph &g, Improvement mode) {
+        bool changeMade = false;
+        Route route(g.nodeNum());
+        // Long tours are reversed in O(sqrt(n)) instead of O(n).
+        std::unique_ptr<TwoLevelRoute> longRoute;
+
+        for (Tour &t : tours) {
+            typename Cost::value_type delta = 0;
+            uint64_t hashDelta = 0;
+            bool tourChanged;
+            if ((int) t.cities.size() >= TwoLevelRoute::MIN_SIZE) {
+                if (!longRoute) longRoute.reset(new TwoLevelRoute(g.nodeNum()));
+                longRoute->assign(t);
+                tourChanged = improve2opt<Cost>(*longRoute, g, mode, delta, hashDelta);
+                if (tourChanged) longRoute->copyTo(t);
+            } else {
+                route.assign(t);
+                tourChanged = improve2opt<Cost>(route, g, mode, delta, hashDelta);
+                if (tourChanged) route.copyTo(t);
+            }
+
+            if (tourChanged) {
+                t.cost += Cost::toDistance(g, delta);
+                t.hash += hashDelta;
+                MAOA_CHECK_TOUR_COST(t, g);
+                changeMade = true;
             }
         }
         return changeMade;
     }
 
-    bool improveByRelocate(std::list<Tour> &tours, const Graph &g) {
+    /*! Converts a distance in evaluation units (see segment.h) to a cost. */
+    template <typename Cost>
+    typename Cost::value_type evaluation(double distance) {
+        return static_cast<typename Cost::value_type>(distance);
+    }
+
+    /*
+     * Don't-look bits: the customers whose neighborhood may contain an
+     * improving move, in a FIFO queue. All customers start active, a customer
+     * is deactivated when no move from it improves, and a move reactivates
+     * the customers whose edges it changed.
+     */
+    class DontLookBits {
+    public:
+        explicit DontLookBits(const Solution &s) : _active(s.graph().nodeNum(), 0), _depot(s.depot()) {
+            for (int i = 0; i < s.graph().nodeNum(); i++) {
+                if (s.isRouted(i)) activate(i);
+            }
+        }
+
+        bool empty() const { return _queue.empty(); }
+        int pop() {
+            const int i = _queue.front();
+            _queue.pop_front();
+            _active[i] = 0;
+            return i;
+        }
+        void activate(int i) {
+            if (i == _depot || _active[i]) return;
+            _active[i] = 1;
+            _queue.push_back(i);
+        }
+
+    private:
+        std::vector<char> _active;
+        std::deque<int> _queue;
+        int _depot;
+    };
+
+    /*
+     * Candidate lists of the inter-route moves: the k nearest customers of
+     * each node (see Graph::neighbors), or every customer when the graph was
+     * loaded without candidate lists.
+     */
+    class Candidates {
+    public:
+        explicit Candidates(const Graph &g) : _g(g) {
+            if (g.neighborCount() > 0) return;
+            for (int i = 0; i < g.nodeNum(); i++) {
+                if (i != g.depotId()) _all.push_back(i);
+            }
+        }
+
+        const int *begin(int i) const { return _all.empty() ? _g.neighbors(i) : _all.data(); }
+        const int *end(int i) const {
+            return _all.empty() ? _g.neighbors(i) + _g.neighborCount() : _all.data() + _all.size();
+        }
+
+    private:
+        const Graph &_g;
+        std::vector<int> _all;
+    };
+
+    template <typename Cost>
+    bool improveByRelocate(Solution &s) {
         bool changeMade = false;
-        std::list<Tour>::iterator t_it1, t_it2;
-
-        begin:
-        // Check all pairs of tours.
-        for (t_it1 = tours.begin(); t_it1 != --tours.end(); t_it1++) {
-            for (t_it2 = std::next(t_it1); t_it2 != tours.end(); t_it2++) {
-
-                // Check if a node of tour1 can be relocated inside tour2.
-                auto c_it1 = t_it1->cities.begin();
-                while (c_it1 != t_it1->cities.end()) {
-                    int currentT1 = *c_it1;
-                    float demandT1 = g.getDemand(currentT1);
-                    // Check capacity of tour2.
-                    if (t_it2->capacity + demandT1 > g.capacity()) {
-                        c_it1++;
-                        continue;
+        const Graph &g = s.graph();
+        const int depotId = g.depotId();
+        const float *demands = g.demands();
+        const Candidates candidates(g);
+        DontLookBits active(s);
+
+        while (!active.empty()) {
+            const int c1 = active.pop();
+            const int r1 = s.routeOf(c1);
+            const int prevT1 = s.prev(c1), nextT1 = s.next(c1);
+            // Tour1 without c1.
+            const Segment newT1 = s.concat(s.prefix(prevT1), s.suffix(nextT1));
+
+            // Insert c1 next to one of its neighbors, before or after it.
+            for (const int *v = candidates.begin(c1); v != candidates.end(c1); v++) {
+                const int r2 = s.routeOf(*v);
+                if (r2 < 0 || r2 == r1) continue;
+                // Check capacity of tour2.
+                if (s.routeLoad(r2) + demands[c1] > g.capacity()) continue;
+
+                typename Cost::value_type currentDistance = evaluation<Cost>(s.routeDistance(r1))
+                                                            + evaluation<Cost>(s.routeDistance(r2));
+                int bestPred = -1;
+                for (int pred : {s.prev(*v), *v}) {
+                    // Tour2 with c1 inserted after pred.
+                    const int succ = (pred == depotId) ? s.first(r2) : s.next(pred);
+                    const Segment newT2 = s.concat(s.prefix(pred), s.node(c1), s.suffix(succ));
+                    typename Cost::value_type distanceIfRelocate = evaluation<Cost>(newT1.distance)
+                                                                   + evaluation<Cost>(newT2.distance);
+                    if (Cost::improves(distanceIfRelocate, currentDistance)) {
+                        currentDistance = distanceIfRelocate;
+                        bestPred = pred;
                     }
+                }
+                if (bestPred >= 0) {
+                    // Implement changes.
+                    const int succ = (bestPred == depotId) ? s.first(r2) : s.next(bestPred);
+                    s.relocate(c1, bestPred, r2);
+                    MAOA_CHECK_SOLUTION(s);
+                    changeMade = true;
+                    for (int i : {c1, prevT1, nextT1, bestPred, succ}) active.activate(i);
+                    break;
+                }
+            }
+        }
+        return changeMade;
+    }
 
-                    // If c_it1 is first node in tour, then previous node is depot.
-                    int prevT1 = (c_it1 == t_it1->cities.begin()) ? g.depotId() : *std::prev(c_it1);
-                    // If c_it1 is last node in tour, then next node is depot.
-                    int nextT1 = (c_it1 == --t_it1->cities.end()) ? g.depotId() : *std::next(c_it1);
-                    double gain_fromRemove = g.getDistance(prevT1, currentT1) + g.getDistance(currentT1, nextT1)
-                                             - g.getDistance(prevT1, nextT1);
-
-                    // Search for the best place to put currentT1 in tour2.
-                    auto c_it2 = t_it2->cities.begin();
-                    while (c_it2 != t_it2->cities.end()) {
-                        int prevT2 = (c_it2 == t_it2->cities.begin()) ? g.depotId() : *std::prev(c_it2);
-                        int currentT2 = *c_it2;
-
-                        double loss_fromAdd = g.getDistance(prevT2, currentT2) - g.getDistance(prevT2, currentT1)
-                                              - g.getDistance(currentT1, currentT2);
-
-                        double totalGain = gain_fromRemove + loss_fromAdd;
-                        if (totalGain > 0) {
-                            // Implement changes.
-                            t_it2->cities.insert(c_it2, currentT1);
-                            t_it2->capacity += demandT1;
-                            t_it1->cities.erase(c_it1);
-                            t_it1->capacity -= demandT1;
-                            changeMade = true;
-                            // Reset search.
-                            goto begin;
-                        }
+    template <typename Cost>
+    bool improveByExchange(Solution &s) {
+        bool changeMade = false;
+        const Graph &g = s.graph();
+        const Candidates candidates(g);
+        DontLookBits active(s);
+
+        while (!active.empty()) {
+            const int c1 = active.pop();
+            const int r1 = s.routeOf(c1);
+            const int prevT1 = s.prev(c1), nextT1 = s.next(c1);
+
+            // Exchange c1 with one of its neighbors.
+            for (const int *v = candidates.begin(c1); v != candidates.end(c1); v++) {
+                const int c2 = *v;
+                const int r2 = s.routeOf(c2);
+                if (r2 < 0 || r2 == r1) continue;
+                const int prevT2 = s.prev(c2), nextT2 = s.next(c2);
+
+                // Each tour with the city of the other one.
+                const Segment newT1 = s.concat(s.prefix(prevT1), s.node(c2), s.suffix(nextT1));
+                const Segment newT2 = s.concat(s.prefix(prevT2), s.node(c1), s.suffix(nextT2));
+
+                // Check that c1 can be exchanged with c2.
+                if (newT1.load > g.capacity() || newT2.load > g.capacity()) continue;
+
+                typename Cost::value_type currentDistance = evaluation<Cost>(s.routeDistance(r1))
+                                                            + evaluation<Cost>(s.routeDistance(r2));
+                typename Cost::value_type distanceIfExchange = evaluation<Cost>(newT1.distance)
+                                                               + evaluation<Cost>(newT2.distance);
+
+                if (Cost::improves(distanceIfExchange, currentDistance)) {
+                    // Implement changes
+                    s.exchange(c1, c2);
+                    MAOA_CHECK_SOLUTION(s);
+                    changeMade = true;
+                    for (int i : {c1, c2, prevT1, nextT1, prevT2, nextT2}) active.activate(i);
+                    break;
+                }
+            }
+        }
+        return changeMade;
+    }
 
-                        c_it2++;
+    /*
+     * 2-opt*: exchanges the tails of two routes so that a customer u becomes
+     * adjacent to one of its candidate neighbors v, of another route. Either
+     * v follows u: the routes become prefix(u) + suffix(v) and
+     * prefix(prev(v)) + suffix(next(u)), or u follows v, symmetrically. The
+     * capacity is checked from the prefix and suffix loads, and the gain
+     * from the four edges changed, both in O(1).
+     */
+    template <typename Cost>
+    bool improveBy2optStar(Solution &s) {
+        typedef typename Cost::value_type value_type;
+        bool changeMade = false;
+        const Graph &g = s.graph();
+        const Candidates candidates(g);
+        DontLookBits active(s);
+
+        while (!active.empty()) {
+            const int u = active.pop();
+            const int r1 = s.routeOf(u);
+            const int pu = s.prev(u), nu = s.next(u);
+
+            value_type bestDelta = 0;
+            int bestV = -1;
+            bool vAfterU = false;
+            for (const int *v = candidates.begin(u); v != candidates.end(u); v++) {
+                const int r2 = s.routeOf(*v);
+                if (r2 < 0 || r2 == r1) continue;
+                const int pv = s.prev(*v), nv = s.next(*v);
+
+                // v follows u.
+                if (s.prefix(u).load + s.suffix(*v).load <= g.capacity()
+                        && s.prefix(pv).load + s.suffix(nu).load <= g.capacity()) {
+                    value_type delta = Cost::distance(g, u, *v) + Cost::distance(g, pv, nu)
+                                       - Cost::distance(g, u, nu) - Cost::distance(g, pv, *v);
+                    if (Cost::improves(delta, bestDelta)) {
+                        bestDelta = delta;
+                        bestV = *v;
+                        vAfterU = true;
+                    }
+                }
+                // u follows v.
+                if (s.prefix(*v).load + s.suffix(u).load <= g.capacity()
+                        && s.prefix(pu).load + s.suffix(nv).load <= g.capacity()) {
+                    value_type delta = Cost::distance(g, *v, u) + Cost::distance(g, pu, nv)
+                                       - Cost::distance(g, pu, u) - Cost::distance(g, *v, nv);
+                    if (Cost::improves(delta, bestDelta)) {
+                        bestDelta = delta;
+                        bestV = *v;
+                        vAfterU = false;
                     }
-                    c_it1++;
                 }
             }
+
+            if (bestV < 0) continue;
+            // Implement changes.
+            const int r2 = s.routeOf(bestV);
+            const int pv = s.prev(bestV), nv = s.next(bestV);
+            if (vAfterU) s.swapTails(u, r1, pv, r2);
+            else s.swapTails(pu, r1, bestV, r2);
+            MAOA_CHECK_SOLUTION(s);
+            changeMade = true;
+            for (int i : {u, bestV, pu, nu, pv, nv}) active.activate(i);
         }
         return changeMade;
     }
 
-    bool improveByExchange(std::list<Tour> &tours, const Graph &g) {
+    /*
+     * Or-opt: moves a chain of 1 to OR_OPT_LENGTH consecutive customers
+     * s1..sL, possibly reversed, between x and its successor y, in the same
+     * route or in another one. With p and n the neighbors of the chain, the
+     * move replaces the edges (p, s1), (sL, n) and (x, y) by (p, n), (x, s1)
+     * and (sL, y) (or (x, sL) and (s1, y) reversed), so it is evaluated in
+     * O(1). The positions tried are around the candidate neighbors of both
+     * ends of the chain.
+     */
+    const int OR_OPT_LENGTH = 3;
+
+    template <typename Cost>
+    bool improveByOrOpt(Solution &s) {
+        typedef typename Cost::value_type value_type;
         bool changeMade = false;
-        std::list<Tour>::iterator t_it1, t_it2;
-
-        begin:
-        // Check all pairs of tours.
-        for (t_it1 = tours.begin(); t_it1 != --tours.end(); t_it1++) {
-            for (t_it2 = std::next(t_it1); t_it2 != tours.end(); t_it2++) {
-
-                // Check all pairs of cities within the tours.
-                auto c_it1 = t_it1->cities.begin();
-                while (c_it1 != t_it1->cities.end()) {
-                    int currentT1 = *c_it1;
-                    float demandT1 = g.getDemand(currentT1);
-
-                    // If c_it1 is first node in tour, then previous node is depot.
-                    int prevT1 = (c_it1 == t_it1->cities.begin()) ? g.depotId() : *std::prev(c_it1);
-                    // If c_it1 is last node in tour, then next node is depot.
-                    int nextT1 = (c_it1 == --t_it1->cities.end()) ? g.depotId() : *std::next(c_it1);
-
-                    double distanceT1 = g.getDistance(prevT1, currentT1) + g.getDistance(currentT1, nextT1);
-
-                    auto c_it2 = t_it2->cities.begin();
-                    while (c_it2 != t_it2->cities.end()) {
-                        int currentT2 = *c_it2;
-                        float demandT2 = g.getDemand(currentT2);
-
-                        // Check that c1 can be exchanged with c2.
-                        if (t_it2->capacity -demandT2 +demandT1 > g.capacity()
-                                || t_it1->capacity -demandT1 +demandT2 > g.capacity()) {
-                            c_it2++;
-                            continue;
+        const Graph &g = s.graph();
+        const int depotId = g.depotId();
+        const Candidates candidates(g);
+        DontLookBits active(s);
+        int chain[OR_OPT_LENGTH];
+
+        while (!active.empty()) {
+            const int s1 = active.pop();
+            const int r1 = s.routeOf(s1);
+            const int p = s.prev(s1);
+
+            value_type bestDelta = 0;
+            int bestLength = 0, bestX = -1, bestRoute = -1;
+            bool bestReversed = false;
+
+            float load = 0;
+            int length = 0;
+            for (int c = s1; c != depotId && length < OR_OPT_LENGTH; c = s.next(c)) {
+                chain[length++] = c;
+                load += g.getDemand(c);
+                const int sL = c, n = s.next(c);
+                const value_type removal = Cost::distance(g, p, n) - Cost::distance(g, p, s1)
+                                           - Cost::distance(g, sL, n);
+
+                for (int end : {s1, sL}) {
+                    if (end == sL && length == 1) break;
+                    for (const int *v = candidates.begin(end); v != candidates.end(end); v++) {
+                        const int r2 = s.routeOf(*v);
+                        if (r2 < 0) continue;
+                        if (r2 != r1 && s.routeLoad(r2) + load > g.capacity()) continue;
+
+                        for (int x : {s.prev(*v), *v}) {
+                            // The edge (x, y) must still exist once the chain is removed. x == p
+                            // is only the current place within the same route: the depot is the
+                            // front of every route.
+                            if ((x == p && r2 == r1) || std::find(chain, chain + length, x) != chain + length) continue;
+                            const int y = (x == depotId) ? s.first(r2) : s.next(x);
+                            const value_type cut = removal - Cost::distance(g, x, y);
+                            const value_type forward = cut + Cost::distance(g, x, s1) + Cost::distance(g, sL, y);
+                            const value_type reversed = cut + Cost::distance(g, x, sL) + Cost::distance(g, s1, y);
+                            if (Cost::improves(forward, bestDelta)) {
+                                bestDelta = forward;
+                                bestLength = length, bestX = x, bestRoute = r2, bestReversed = false;
+                            }
+                            if (length > 1 && Cost::improves(reversed, bestDelta)) {
+                                bestDelta = reversed;
+                                bestLength = length, bestX = x, bestRoute = r2, bestReversed = true;
+                            }
                         }
+                    }
+                }
+            }
 
-                        // If c_it1 is first node in tour, then previous node is depot.
-                        int prevT2 = (c_it2 == t_it2->cities.begin()) ? g.depotId() : *std::prev(c_it2);
-                        // If c_it1 is last node in tour, then next node is depot.
-                        int nextT2 = (c_it2 == --t_it2->cities.end()) ? g.depotId() : *std::next(c_it2);
-
-                        // Compute distance of current tour
-                        double currentDistance = distanceT1 + g.getDistance(prevT2, currentT2)
-                                                 + g.getDistance(currentT2, nextT2);
-
-                        double distanceIfExchange = g.getDistance(prevT1, currentT2)
-                                                    + g.getDistance(currentT2, nextT1)
-                                                    + g.getDistance(prevT2, currentT1)
-                                                    + g.getDistance(currentT1, nextT2);
-
-                        if (distanceIfExchange < currentDistance) {
-                            // Implement changes
-                            t_it1->cities.insert(c_it1, currentT2);
-                            t_it2->cities.insert(c_it2, currentT1);
-                            t_it1->cities.erase(c_it1);
-                            t_it2->cities.erase(c_it2);
-                            t_it1->capacity += demandT2 -demandT1;
-                            t_it2->capacity += demandT1 -demandT2;
-                            changeMade = true;
-                            // Reset search.
-                            goto begin;
-                        }
+            if (bestLength == 0) continue;
+            // Implement changes, one city at a time.
+            const int n = s.next(chain[bestLength - 1]);
+            const int y = (bestX == depotId) ? s.first(bestRoute) : s.next(bestX);
+            int pred = bestX;
+            for (int k = 0; k < bestLength; k++) {
+                const int c = chain[bestReversed ? bestLength - 1 - k : k];
+                s.relocate(c, pred, bestRoute);
+                pred = c;
+            }
+            MAOA_CHECK_SOLUTION(s);
+            changeMade = true;
+            for (int i : {p, n, bestX, y}) active.activate(i);
+            for (int k = 0; k < bestLength; k++) active.activate(chain[k]);
+        }
+        return changeMade;
+    }
 
-                        c_it2++;
+    /*
+     * Polar sector of a route around the depot, as an arc of angles in
+     * [0, 65536). Routes whose sectors do not overlap are not worth a SWAP*.
+     * On instances without coordinates every sector is a single angle, and
+     * all of them overlap.
+     */
+    class CircleSector {
+    public:
+        static int angle(const Graph &g, int i) {
+            const int depotId = g.depotId();
+            const double theta = std::atan2(g.ys()[i] - g.ys()[depotId], g.xs()[i] - g.xs()[depotId]);
+            return _mod((int) (32768. * theta / M_PI));
+        }
+
+        void reset(int point) { _start = _end = point; }
+        void extend(int point) {
+            if (_mod(point - _start) <= _mod(_end - _start)) return;
+            if (_mod(point - _end) <= _mod(_start - point)) _end = point;
+            else _start = point;
+        }
+        bool overlaps(const CircleSector &other) const {
+            return _mod(other._start - _start) <= _mod(_end - _start)
+                   || _mod(_start - other._start) <= _mod(other._end - other._start);
+        }
+
+    private:
+        int _start, _end;
+
+        static int _mod(int i) { return (i % 65536 + 65536) % 65536; }
+    };
+
+    /*! The three cheapest places to insert a customer in a route. */
+    template <typename Cost>
+    struct Top3 {
+        typename Cost::value_type cost[3];
+        int pred[3]; // The customer goes after pred, -1 for no place.
+
+        void reset() { pred[0] = pred[1] = pred[2] = -1; }
+        void add(typename Cost::value_type c, int p) {
+            int k = 3;
+            while (k > 0 && (pred[k - 1] < 0 || c < cost[k - 1])) k--;
+            if (k == 3) return;
+            for (int j = 2; j > k; j--) {
+                cost[j] = cost[j - 1];
+                pred[j] = pred[j - 1];
+            }
+            cost[k] = c;
+            pred[k] = p;
+        }
+    };
+
+    /*
+     * SWAP* (Vidal 2020): exchanges a customer u of a route with a customer v
+     * of another route, each being reinserted at its best place in the other
+     * route rather than in the place of the other customer. For a pair of
+     * routes, the three cheapest insertion places of every customer in the
+     * other route are computed once, in O(|r1| |r2|). Then every (u, v) is
+     * evaluated in O(1): at most two of the three places are next to the
+     * removed customer, and the place of the removed customer is always
+     * available.
+     *
+     * Only the pairs of routes whose polar sectors overlap are tried, and a
+     * pair is tried again only when one of its routes changed.
+     */
+    template <typename Cost>
+    class SwapStar {
+    public:
+        typedef typename Cost::value_type value_type;
+
+        explicit SwapStar(Solution &s) : _s(s), _g(s.graph()), _depot(s.depot()), _top(_g.nodeNum()) {}
+
+        bool run() {
+            const int routes = _s.routeSlots();
+            std::vector<CircleSector> sectors(routes);
+            std::vector<int> modified(routes, 0), tested(routes, -1);
+            for (int r = 0; r < routes; r++) _sector(r, sectors[r]);
+            int clock = 0;
+            bool changeMade = false, improved;
+
+            do {
+                improved = false;
+                for (int r1 = 0; r1 < routes; r1++) {
+                    if (_s.routeSize(r1) == 0) continue;
+                    const int start = clock;
+                    for (int r2 = r1 + 1; r2 < routes; r2++) {
+                        if (_s.routeSize(r1) == 0) break;
+                        if (_s.routeSize(r2) == 0 || !sectors[r1].overlaps(sectors[r2])) continue;
+                        if (modified[r1] <= tested[r1] && modified[r2] <= tested[r1]) continue;
+                        if (!_improve(r1, r2)) continue;
+                        MAOA_CHECK_SOLUTION(_s);
+                        modified[r1] = modified[r2] = ++clock;
+                        _sector(r1, sectors[r1]);
+                        _sector(r2, sectors[r2]);
+                        changeMade = improved = true;
                     }
+                    tested[r1] = start;
+                }
+            } while (improved);
+            return changeMade;
+        }
+
+    private:
+        Solution &_s;
+        const Graph &_g;
+        const int _depot;
+        std::vector<Top3<Cost>> _top;
+
+        value_type _d(int i, int j) const { return Cost::distance(_g, i, j); }
+
+        void _sector(int r, CircleSector &sector) const {
+            if (_s.routeSize(r) == 0) return;
+            sector.reset(CircleSector::angle(_g, _s.first(r)));
+            for (int c = _s.next(_s.first(r)); c != _depot; c = _s.next(c)) {
+                sector.extend(CircleSector::angle(_g, c));
+            }
+        }
+
+        /*! Computes the three best places in route `to` of the customers of `from`. */
+        void _preprocess(int from, int to) {
+            for (int u = _s.first(from); u != _depot; u = _s.next(u)) {
+                Top3<Cost> &top = _top[u];
+                top.reset();
+                int x = _depot;
+                do {
+                    const int y = (x == _depot) ? _s.first(to) : _s.next(x);
+                    top.add(_d(x, u) + _d(u, y) - _d(x, y), x);
+                    x = y;
+                } while (x != _depot);
+            }
+        }
 
-                    c_it1++;
+        /*! Cheapest insertion of u in the route of `removed` once `removed`
+         * is taken out, sets `pred` to the place. */
+        value_type _insertion(int u, int removed, int &pred) const {
+            const int p = _s.prev(removed), n = _s.next(removed);
+            // In the place of the removed customer.
+            value_type best = _d(p, u) + _d(u, n) - _d(p, n);
+            pred = p;
+            const Top3<Cost> &top = _top[u];
+            for (int k = 0; k < 3 && top.pred[k] >= 0; k++) {
+                const int x = top.pred[k];
+                const int y = (x == _depot) ? _s.first(_s.routeOf(removed)) : _s.next(x);
+                if (x == removed || y == removed) continue;
+                if (top.cost[k] < best) {
+                    best = top.cost[k];
+                    pred = x;
                 }
+                break;
             }
+            return best;
         }
-        return changeMade;
+
+        /*! Applies the best SWAP* between routes r1 and r2, if it improves. */
+        bool _improve(int r1, int r2) {
+            _preprocess(r1, r2);
+            _preprocess(r2, r1);
+            const float *demands = _g.demands();
+
+            value_type bestDelta = 0;
+            int bestU = -1, bestV = -1, bestPredU = -1, bestPredV = -1;
+            for (int u = _s.first(r1); u != _depot; u = _s.next(u)) {
+                const value_type removeU = _d(_s.prev(u), _s.next(u)) - _d(_s.prev(u), u) - _d(u, _s.next(u));
+                for (int v = _s.first(r2); v != _depot; v = _s.next(v)) {
+                    if (_s.routeLoad(r1) - demands[u] + demands[v] > _g.capacity()
+                            || _s.routeLoad(r2) - demands[v] + demands[u] > _g.capacity()) continue;
+                    const value_type removeV = _d(_s.prev(v), _s.next(v)) - _d(_s.prev(v), v) - _d(v, _s.next(v));
+                    int predU, predV;
+                    const value_type delta = removeU + removeV + _insertion(u, v, predU) + _insertion(v, u, predV);
+                    if (Cost::improves(delta, bestDelta)) {
+                        bestDelta = delta;
+                        bestU = u, bestV = v, bestPredU = predU, bestPredV = predV;
+                    }
+                }
+            }
+            if (bestU < 0) return false;
+
+            // Implement changes.
+            _s.remove(bestU);
+            _s.remove(bestV);
+            _s.insertAfter(bestV, bestPredV, r1);
+            _s.insertAfter(bestU, bestPredU, r2);
+            return true;
+        }
+    };
+
+} // namespace
+
+    double getTotalTourDistance(CityList &t, const Graph &g) {
+        if (g.hasIntegerCosts()) return IntCost::toDistance(g, tourCost<IntCost>(t, g));
+        return tourCost<RealCost>(t, g);
+    }
+
+    double getTotalCost(std::list<Tour> &tours, const Graph &g) {
+        if (g.hasIntegerCosts()) {
+            long long totalCost = 0;
+            for (Tour &t : tours) {
+                totalCost += tourCost<IntCost>(t.cities, g);
+            }
+            return IntCost::toDistance(g, totalCost);
+        }
+        double totalCost = 0;
+        for (Tour &t : tours) {
+            totalCost += tourCost<RealCost>(t.cities, g);
+        }
+        return totalCost;
     }
 
-    void descent(std::list<Tour> &tours, const Graph &g) {
+    bool improve2opt(std::list<Tour> &tours, const Graph &g, Improvement mode) {
+        return g.hasIntegerCosts() ? improve2opt<IntCost>(tours, g, mode) : improve2opt<RealCost>(tours, g, mode);
+    }
+
+    bool improveByRelocate(Solution &s) {
+        return s.graph().hasIntegerCosts() ? improveByRelocate<IntCost>(s) : improveByRelocate<RealCost>(s);
+    }
+
+    bool improveByRelocate(std::list<Tour> &tours, const Graph &g) {
+        Solution s(g, tours);
+        if (!improveByRelocate(s)) return false;
+        tours = s.toTours();
+        return true;
+    }
+
+    bool improveByExchange(Solution &s) {
+        return s.graph().hasIntegerCosts() ? improveByExchange<IntCost>(s) : improveByExchange<RealCost>(s);
+    }
+
+    bool improveByExchange(std::list<Tour> &tours, const Graph &g) {
+        Solution s(g, tours);
+        if (!improveByExchange(s)) return false;
+        tours = s.toTours();
+        return true;
+    }
+
+    bool improveBySwapStar(Solution &s) {
+        if (s.graph().hasIntegerCosts()) return SwapStar<IntCost>(s).run();
+        return SwapStar<RealCost>(s).run();
+    }
+
+    bool improveBySwapStar(std::list<Tour> &tours, const Graph &g) {
+        Solution s(g, tours);
+        if (!improveBySwapStar(s)) return false;
+        tours = s.toTours();
+        return true;
+    }
+
+    bool improveBy2optStar(Solution &s) {
+        return s.graph().hasIntegerCosts() ? improveBy2optStar<IntCost>(s) : improveBy2optStar<RealCost>(s);
+    }
+
+    bool improveBy2optStar(std::list<Tour> &tours, const Graph &g) {
+        Solution s(g, tours);
+        if (!improveBy2optStar(s)) return false;
+        tours = s.toTours();
+        return true;
+    }
+
+    bool improveByOrOpt(Solution &s) {
+        return s.graph().hasIntegerCosts() ? improveByOrOpt<IntCost>(s) : improveByOrOpt<RealCost>(s);
+    }
+
+    bool improveByOrOpt(std::list<Tour> &tours, const Graph &g) {
+        Solution s(g, tours);
+        if (!improveByOrOpt(s)) return false;
+        tours = s.toTours();
+        return true;
+    }
+
+    double getCachedCost(const std::list<Tour> &tours) {
+        double totalCost = 0;
+        for (const Tour &t : tours) {
+            totalCost += t.cost;
+        }
+        return totalCost;
+    }
+
+    void descent(std::list<Tour> &tours, const Graph &g, Improvement mode) {
+        // The procedures update the costs and hashes by delta from here on.
+        for (Tour &t : tours) {
+            t.updateCost(g);
+            t.updateHash(g);
+        }
+        Solution s(g);
         bool changeMade;
         do {
             changeMade = false;
-            changeMade = changeMade || improve2opt(tours, g);
-            changeMade = changeMade || improveByRelocate(tours, g);
-            changeMade = changeMade || improveByExchange(tours, g);
-            double totalCost = getTotalCost(tours, g);
+            changeMade = changeMade || improve2opt(tours, g, mode);
+            if (!changeMade) {
+                // Inter-route moves work on the flat representation.
+                s.assign(tours);
+                changeMade = improveByRelocate(s) || improveByExchange(s) || improveBySwapStar(s)
+                             || improveBy2optStar(s) || improveByOrOpt(s);
+                if (changeMade) tours = s.toTours();
+            }
+            double totalCost = getCachedCost(tours);
             std::cout << "Total cost is: " << totalCost << std::endl;
         } while (changeMade);
     }
 } // namespace idesc
 } // namespace maoa
-
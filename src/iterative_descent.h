@@ -1,4 +1,5 @@
 #include "graph.h"
+#include "solution.h"
 
 #ifndef PMAOA_ITERATIVE_DESCENT_H
 #define PMAOA_ITERATIVE_DESCENT_H
@@ -6,6 +7,12 @@
 namespace maoa {
 namespace idesc {
 
+    /*! Move applied by the intra-route procedures at each step. */
+    enum class Improvement {
+        First, //!< The first improving move found, the scan goes on from it.
+        Best   //!< The best move of the whole neighborhood.
+    };
+
     /*!
      * Returns the total distance between a string of cities, with the depot of
      * the graph \a g as starting and ending point.
@@ -13,7 +20,7 @@ namespace idesc {
      * @param g Graph containing the cities of \a t.
      * @return The total distance.
      */
-    double getTotalTourDistance(std::list<int> &t, const Graph &g);
+    double getTotalTourDistance(CityList &t, const Graph &g);
 
     /*!
      * Returns the total distance of a solution, that is the sum of total tour
@@ -24,49 +31,128 @@ namespace idesc {
      */
     double getTotalCost(std::list<Tour> &tours, const Graph &g);
 
+    /*!
+     * Returns the total distance of a solution from the cached cost of each
+     * tour (see Tour::cost), in O(number of tours).
+     * @param tours List of tours
+     * @return The total cost of the solution.
+     */
+    double getCachedCost(const std::list<Tour> &tours);
+
     /*!
      * Improves a list of tours by exploring the 2-opt neighborhood of each
      * tour. For each tour, the edges between four cities are deleted and the
      * cities are reconnected to construct a new and different tour. If the new
      * tour has a total distance inferior to the original distance, the new tour
      * is kept. The procedure ends when no 2-opt improvements can be made.
+     * Every move is evaluated in O(1) from the four edges it changes, and
+     * only the accepted ones reverse the tour, in place.
+     * The cost of every tour must be up to date (see Tour::updateCost), it is
+     * updated by delta as the tours change. The same holds for the other
+     * improvement procedures.
      * @param tours List of tours to improve.
      * @param g Graph containing the tours.
+     * @param mode Whether the first or the best improving move is applied.
      * @return Boolean indicating if a change was made to any of the tours.
      */
-    bool improve2opt(std::list<Tour> &tours, const Graph &g);
+    bool improve2opt(std::list<Tour> &tours, const Graph &g, Improvement mode = Improvement::First);
 
     /*!
      * Improves a list of tours by relocating a city from one tour to another.
-     * For every city in the graph, the procedure tries to relocate it in a new
-     * tour at the best location. The procedure ends when no improving
-     * relocation can be made.
+     * A city is only inserted next to one of its candidate neighbors (see
+     * Graph::neighbors), in another tour. Don't-look bits restrict the search
+     * to the cities whose edges were changed by the last moves. The procedure
+     * ends when no improving relocation can be made.
      * @param tours List of tours to improve.
      * @param g Graph containing the tours.
      * @return Boolean indicating if a change was made to any of the tours.
      */
     bool improveByRelocate(std::list<Tour> &tours, const Graph &g);
 
+    /*! Same as above on a Solution, which avoids converting the tours. */
+    bool improveByRelocate(Solution &s);
+
     /*!
      * Improves a list of tours by exchanging two cities between tours. For
-     * every pair of city that are not in the same tour, if the exchange is
-     * possible and improves the distance of the two corresponding tours, it is
-     * implemented. The procedure ends when no improving exchange can be made.
+     * every city and each of its candidate neighbors in another tour, if the
+     * exchange is possible and improves the distance of the two corresponding
+     * tours, it is implemented. The cities are examined under don't-look bits
+     * as for improveByRelocate. The procedure ends when no improving exchange
+     * can be made.
      * @param tours List of tours to improve.
      * @param g Graph containing the tours.
      * @return Boolean indicating if a change was made to any of the tours.
      */
     bool improveByExchange(std::list<Tour> &tours, const Graph &g);
 
+    /*! Same as above on a Solution, which avoids converting the tours. */
+    bool improveByExchange(Solution &s);
+
+    /*!
+     * Improves a list of tours by SWAP* moves: a city of a tour and a city of
+     * another tour are exchanged, each one being reinserted at its best place
+     * in the other tour. The three cheapest insertion places of every city
+     * of a pair of tours are computed once per pair, so that each exchange
+     * is evaluated in amortized O(1). Only the pairs of tours whose polar
+     * sectors around the depot overlap are tried, and a pair is tried again
+     * only once one of its tours changed. The procedure ends when no
+     * improving move can be made.
+     * @param tours List of tours to improve.
+     * @param g Graph containing the tours.
+     * @return Boolean indicating if a change was made to any of the tours.
+     */
+    bool improveBySwapStar(std::list<Tour> &tours, const Graph &g);
+
+    /*! Same as above on a Solution, which avoids converting the tours. */
+    bool improveBySwapStar(Solution &s);
+
+    /*!
+     * Improves a list of tours by 2-opt* moves: the tails of two tours are
+     * exchanged so that a city becomes adjacent to one of its candidate
+     * neighbors (see Graph::neighbors). The capacity of both new tours is
+     * checked from prefix loads and the gain from the four edges changed,
+     * in O(1). The cities are examined under don't-look bits as for
+     * improveByRelocate. The procedure ends when no improving move can be
+     * made.
+     * @param tours List of tours to improve.
+     * @param g Graph containing the tours.
+     * @return Boolean indicating if a change was made to any of the tours.
+     */
+    bool improveBy2optStar(std::list<Tour> &tours, const Graph &g);
+
+    /*! Same as above on a Solution, which avoids converting the tours. */
+    bool improveBy2optStar(Solution &s);
+
+    /*!
+     * Improves a list of tours by Or-opt moves: a chain of 1 to 3 consecutive
+     * cities is moved, possibly reversed, to another place of the same tour
+     * or of another tour. Every move is evaluated in O(1) from the three
+     * edges it removes and the three it adds. Chains are placed next to the
+     * candidate neighbors of their ends, and the cities are examined under
+     * don't-look bits as for improveByRelocate. For every city the best move
+     * of its chains is applied. The procedure ends when no improving move can
+     * be made.
+     * @param tours List of tours to improve.
+     * @param g Graph containing the tours.
+     * @return Boolean indicating if a change was made to any of the tours.
+     */
+    bool improveByOrOpt(std::list<Tour> &tours, const Graph &g);
+
+    /*! Same as above on a Solution, which avoids converting the tours. */
+    bool improveByOrOpt(Solution &s);
+
     /*!
      * Performs an iterative improvement procedure. The tours are improved with
      * several procedures in the following order: 2-opt neighborhood, relocating
-     * of one city, exchange of city. The procedure ends when no improving
-     * changes can be made.
+     * of one city, exchange of two cities, SWAP*, 2-opt*, Or-opt. The plain
+     * exchange is cheap and runs first; SWAP* then finds the exchanges whose
+     * cities are better reinserted elsewhere in the other route. The procedure
+     * ends when no improving changes can be made.
      * @param tours List of tours to improve.
      * @param g Graph containing the tours.
+     * @param mode Move selection of the 2-opt procedure.
      */
-    void descent(std::list<Tour> &tours, const Graph &g);
+    void descent(std::list<Tour> &tours, const Graph &g, Improvement mode = Improvement::First);
 
 } // namespace idesc
 } // namespace maoa
@@ -0,0 +1,74 @@
+#ifndef PMAOA_METRIC_H
+#define PMAOA_METRIC_H
+
+#include <algorithm>
+#include <cmath>
+
+namespace maoa {
+
+    /*!
+     * Distance functions of the coordinate based EDGE_WEIGHT_TYPEs, following
+     * the TSPLIB definitions. Each one is a policy of the templated distance
+     * kernel of Graph, which is chosen once when the instance is loaded so
+     * that the inner loop is fully inlined.
+     *
+     * EUC_2D, CEIL_2D and MAN_2D return exact values, Graph applies the
+     * Rounding afterwards. ATT and GEO include their own integer rounding
+     * (GEO is 1 between a node and itself, the kernel resets the diagonal).
+     */
+    namespace metric {
+
+        /*! Euclidean distance (EUC_2D and CEIL_2D). */
+        struct Euclidean {
+            static double distance(double xi, double yi, double xj, double yj) {
+                const double dx = xi - xj;
+                const double dy = yi - yj;
+                return std::sqrt(dx * dx + dy * dy);
+            }
+        };
+
+        /*! Manhattan distance (MAN_2D). */
+        struct Manhattan {
+            static double distance(double xi, double yi, double xj, double yj) {
+                return std::fabs(xi - xj) + std::fabs(yi - yj);
+            }
+        };
+
+        /*! Pseudo-euclidean distance of the att48 and att532 instances (ATT). */
+        struct Att {
+            static double distance(double xi, double yi, double xj, double yj) {
+                const double dx = xi - xj;
+                const double dy = yi - yj;
+                const double r = std::sqrt((dx * dx + dy * dy) / 10.0);
+                const double t = std::floor(r + 0.5);
+                return t < r ? t + 1 : t;
+            }
+        };
+
+        /*!
+         * Geographical distance in kilometers on an idealized sphere (GEO).
+         * Coordinates are latitude (x) and longitude (y) in DDD.MM format.
+         */
+        struct Geo {
+            static double distance(double xi, double yi, double xj, double yj) {
+                const double RRR = 6378.388;
+                const double latI = radians(xi), lonI = radians(yi);
+                const double latJ = radians(xj), lonJ = radians(yj);
+                const double q1 = std::cos(lonI - lonJ);
+                const double q2 = std::cos(latI - latJ);
+                const double q3 = std::cos(latI + latJ);
+                const double c = std::min(1.0, 0.5 * ((1.0 + q1) * q2 - (1.0 - q1) * q3));
+                return (int) (RRR * std::acos(c) + 1.0);
+            }
+
+            static double radians(double v) {
+                const double PI = 3.141592;
+                const int deg = (int) v;
+                const double min = v - deg;
+                return PI * (deg + 5.0 * min / 3.0) / 180.0;
+            }
+        };
+    }
+}
+
+#endif //PMAOA_METRIC_H
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+
+#include "neighbor_lists.h"
+
+namespace maoa {
+
+    void buildNeighborLists(const float *x, const float *y, int n, int depotId, int k,
+                            std::vector<int> &out) {
+        out.assign((size_t) n * k, -1);
+        if (k <= 0 || n <= 0) return;
+
+        // Square grid over the bounding box with about two nodes per cell.
+        float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (int i = 1; i < n; i++) {
+            minX = std::min(minX, x[i]);
+            maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]);
+            maxY = std::max(maxY, y[i]);
+        }
+        const int side = std::max(1, (int) std::sqrt(n / 2.0));
+        double extent = std::max(maxX - minX, maxY - minY);
+        if (extent <= 0) extent = 1;
+        const double cellSize = extent / side;
+
+        auto cellCoord = [&](double v, double origin) {
+            return std::min(side - 1, std::max(0, (int) ((v - origin) / cellSize)));
+        };
+
+        // Bucket the customers by cell (counting sort).
+        std::vector<int> cellStart(side * side + 1, 0);
+        std::vector<int> cellOf(n);
+        for (int i = 0; i < n; i++) {
+            cellOf[i] = cellCoord(y[i], minY) * side + cellCoord(x[i], minX);
+            if (i != depotId) cellStart[cellOf[i] + 1]++;
+        }
+        for (int c = 0; c < side * side; c++) cellStart[c + 1] += cellStart[c];
+        std::vector<int> cellNodes(cellStart[side * side]);
+        std::vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+        for (int i = 0; i < n; i++) {
+            if (i != depotId) cellNodes[fill[cellOf[i]]++] = i;
+        }
+
+        // Max-heap of the best candidates found so far, ordered by (d2, id).
+        typedef std::pair<double, int> Candidate;
+        std::vector<Candidate> heap;
+        heap.reserve(k + 1);
+
+        for (int i = 0; i < n; i++) {
+            const double xi = x[i], yi = y[i];
+            const int cx = cellOf[i] % side, cy = cellOf[i] / side;
+            heap.clear();
+
+            auto visitCell = [&](int gx, int gy) {
+                if (gx < 0 || gy < 0 || gx >= side || gy >= side) return;
+                const int c = gy * side + gx;
+                for (int p = cellStart[c]; p < cellStart[c + 1]; p++) {
+                    const int j = cellNodes[p];
+                    if (j == i) continue;
+                    const double dx = xi - x[j], dy = yi - y[j];
+                    Candidate cand(dx * dx + dy * dy, j);
+                    if ((int) heap.size() < k) {
+                        heap.push_back(cand);
+                        std::push_heap(heap.begin(), heap.end());
+                    } else if (cand < heap.front()) {
+                        std::pop_heap(heap.begin(), heap.end());
+                        heap.back() = cand;
+                        std::push_heap(heap.begin(), heap.end());
+                    }
+                }
+            };
+
+            // Visit square rings of cells around the cell of i, until the
+            // ring cannot hold anything closer than the current k-th best.
+            for (int r = 0; r <= side; r++) {
+                if (r > 0 && (int) heap.size() == k) {
+                    // Distance from i to the border of the rings already seen,
+                    // ignoring the sides that reached the edge of the grid.
+                    const double inf = HUGE_VAL;
+                    double left = cx - r + 1 <= 0 ? inf : xi - minX - (cx - r + 1) * cellSize;
+                    double right = cx + r - 1 >= side - 1 ? inf : (cx + r) * cellSize - (xi - minX);
+                    double bottom = cy - r + 1 <= 0 ? inf : yi - minY - (cy - r + 1) * cellSize;
+                    double top = cy + r - 1 >= side - 1 ? inf : (cy + r) * cellSize - (yi - minY);
+                    double bound = std::min(std::min(left, right), std::min(bottom, top));
+                    if (bound > 0 && bound * bound > heap.front().first) break;
+                }
+                for (int gy = cy - r; gy <= cy + r; gy++) {
+                    if (gy == cy - r || gy == cy + r) {
+                        for (int gx = cx - r; gx <= cx + r; gx++) visitCell(gx, gy);
+                    } else {
+                        visitCell(cx - r, gy);
+                        visitCell(cx + r, gy);
+                    }
+                }
+            }
+
+            std::sort_heap(heap.begin(), heap.end());
+            int *row = out.data() + (size_t) i * k;
+            for (size_t p = 0; p < heap.size(); p++) row[p] = heap[p].second;
+        }
+    }
+
+    namespace {
+
+        /*! Partial sort of every row given by \a rowOf(i). */
+        template <typename RowOf>
+        void buildFromRows(int n, int depotId, int k, RowOf rowOf, std::vector<int> &out) {
+            out.assign((size_t) n * k, -1);
+            if (k <= 0 || n <= 0) return;
+
+            std::vector<int> candidates;
+            candidates.reserve(n);
+            for (int i = 0; i < n; i++) {
+                const auto *row = rowOf(i);
+                auto closer = [&](int a, int b) {
+                    return row[a] < row[b] || (row[a] == row[b] && a < b);
+                };
+                candidates.clear();
+                for (int j = 0; j < n; j++) {
+                    if (j != i && j != depotId) candidates.push_back(j);
+                }
+                const int m = std::min(k, (int) candidates.size());
+                if (m == 0) continue;
+                std::nth_element(candidates.begin(), candidates.begin() + m - 1, candidates.end(), closer);
+                std::sort(candidates.begin(), candidates.begin() + m, closer);
+                std::copy(candidates.begin(), candidates.begin() + m, out.begin() + (size_t) i * k);
+            }
+        }
+    }
+
+    template <typename T>
+    void buildNeighborLists(const DistanceMatrix<T> &distances, int depotId, int k,
+                            std::vector<int> &out) {
+        buildFromRows(distances.size(), depotId, k, [&](int i) { return distances.row(i); }, out);
+    }
+
+    void buildNeighborLists(int n, int depotId, int k, const std::function<const double *(int)> &row,
+                            std::vector<int> &out) {
+        buildFromRows(n, depotId, k, row, out);
+    }
+
+    template void buildNeighborLists(const DistanceMatrix<double> &, int, int, std::vector<int> &);
+    template void buildNeighborLists(const DistanceMatrix<int32_t> &, int, int, std::vector<int> &);
+}
@@ -0,0 +1,53 @@
+#ifndef PMAOA_NEIGHBOR_LISTS_H
+#define PMAOA_NEIGHBOR_LISTS_H
+
+#include <functional>
+#include <vector>
+
+#include "distance_matrix.h"
+
+namespace maoa {
+
+    /*!
+     * Computes the \a k nearest customers of every node from the coordinates,
+     * using a uniform grid so that the whole construction runs in about
+     * O(n k log k) instead of sorting every row of the distance matrix. The
+     * depot and the node itself are never part of a list.
+     * @param x Abscissa of each node.
+     * @param y Ordinate of each node.
+     * @param n Number of nodes.
+     * @param depotId Id of the depot.
+     * @param k Number of neighbors per node, at most n-2.
+     * @param out Flat array of n*k ids: the neighbors of node i are stored
+     * in out[i*k .. i*k+k-1], by increasing distance.
+     */
+    void buildNeighborLists(const float *x, const float *y, int n, int depotId, int k,
+                            std::vector<int> &out);
+
+    /*!
+     * Same as above for instances without coordinates: every row of the
+     * distance matrix is partially sorted, which costs O(n^2).
+     * @param distances Distances between every pair of nodes.
+     * @param depotId Id of the depot.
+     * @param k Number of neighbors per node, at most n-2.
+     * @param out Flat array of n*k ids, as above.
+     */
+    template <typename T>
+    void buildNeighborLists(const DistanceMatrix<T> &distances, int depotId, int k,
+                            std::vector<int> &out);
+
+    /*!
+     * Same as above with rows computed on demand, for metrics where the
+     * euclidean grid does not give the nearest nodes.
+     * @param n Number of nodes.
+     * @param depotId Id of the depot.
+     * @param k Number of neighbors per node, at most n-2.
+     * @param row Returns the distances from node i to every node. The pointer
+     * only needs to stay valid until the next call.
+     * @param out Flat array of n*k ids, as above.
+     */
+    void buildNeighborLists(int n, int depotId, int k, const std::function<const double *(int)> &row,
+                            std::vector<int> &out);
+}
+
+#endif //PMAOA_NEIGHBOR_LISTS_H
@@ -0,0 +1,110 @@
+#ifndef PMAOA_POOL_ALLOCATOR_H
+#define PMAOA_POOL_ALLOCATOR_H
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace maoa {
+
+    /*!
+     * Per-thread pool of fixed-size blocks. Blocks are carved from chunks of
+     * growing size and recycled through a free list, the chunks are only
+     * given back when the thread exits. Construction loops that build and
+     * drop the same lists over and over (multi-start retries, ants) then
+     * stop calling the system allocator after their first iteration.
+     */
+    template <std::size_t SIZE, std::size_t ALIGN>
+    class NodePool {
+    public:
+        /*! Pool of the calling thread. */
+        static NodePool &local() {
+            static thread_local NodePool pool;
+            return pool;
+        }
+
+        void *allocate() {
+            if (_free == nullptr) _grow();
+            Block *block = _free;
+            _free = block->next;
+            return block;
+        }
+
+        void deallocate(void *p) {
+            Block *block = static_cast<Block *>(p);
+            block->next = _free;
+            _free = block;
+        }
+
+        ~NodePool() {
+            for (Block *chunk : _chunks) ::operator delete(chunk);
+        }
+
+    private:
+        union Block {
+            Block *next;
+            alignas(ALIGN) unsigned char storage[SIZE];
+        };
+
+        static const std::size_t MAX_CHUNK = 1 << 16;
+
+        Block *_free = nullptr;
+        std::vector<Block *> _chunks;
+        std::size_t _chunkSize = 256;
+
+        NodePool() = default;
+
+        void _grow() {
+            Block *chunk = static_cast<Block *>(::operator new(_chunkSize * sizeof(Block)));
+            _chunks.push_back(chunk);
+            for (std::size_t i = 0; i < _chunkSize; i++) {
+                chunk[i].next = (i + 1 < _chunkSize) ? &chunk[i + 1] : nullptr;
+            }
+            _free = chunk;
+            if (_chunkSize < MAX_CHUNK) _chunkSize *= 2;
+        }
+    };
+
+    /*!
+     * Standard allocator drawing single objects (the nodes of a std::list)
+     * from the NodePool of the calling thread. Larger requests go to the
+     * default allocator. A container using it must be destroyed by the
+     * thread that filled it, before that thread exits.
+     */
+    template <typename T>
+    class PoolAllocator {
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind {
+            typedef PoolAllocator<U> other;
+        };
+
+        PoolAllocator() = default;
+        template <typename U>
+        PoolAllocator(const PoolAllocator<U> &) {}
+
+        T *allocate(std::size_t n) {
+            if (n == 1) return static_cast<T *>(NodePool<sizeof(T), alignof(T)>::local().allocate());
+            return std::allocator<T>().allocate(n);
+        }
+
+        void deallocate(T *p, std::size_t n) {
+            if (n == 1) NodePool<sizeof(T), alignof(T)>::local().deallocate(p);
+            else std::allocator<T>().deallocate(p, n);
+        }
+    };
+
+    template <typename T, typename U>
+    bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) { return true; }
+    template <typename T, typename U>
+    bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) { return false; }
+
+    /*! List of node ids whose nodes come from the thread pool. */
+    typedef std::list<int, PoolAllocator<int>> CityList;
+}
+
+#endif //PMAOA_POOL_ALLOCATOR_H
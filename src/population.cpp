@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstring>
+
+#include "population.h"
+
+namespace maoa {
+
+    Population::Population(const Graph &g, int capacity)
+            : _g(&g), _capacity(capacity), _size(0), _length(capacity), _cost(capacity), _hash(capacity) {
+        assert(supports(g));
+        // Every customer and at most one depot per customer.
+        const std::size_t words = 2 * ((std::size_t) g.nodeNum() - 1);
+        const std::size_t line = AlignedArray<Word>::ALIGNMENT / sizeof(Word);
+        _stride = (words + line - 1) / line * line;
+        _words.resize((std::size_t) capacity * _stride);
+    }
+
+    int Population::routeCount(int i) const {
+        const Word *words = data(i);
+        int count = 0;
+        for (uint32_t k = 0; k < _length[i]; k++) {
+            if (words[k] == _g->depotId()) count++;
+        }
+        return count;
+    }
+
+    int Population::add(const Solution &s) {
+        assert(!full());
+        encode(_size, s);
+        return _size++;
+    }
+
+    int Population::add(const std::list<Tour> &tours) {
+        assert(!full());
+        encode(_size, tours);
+        return _size++;
+    }
+
+    void Population::encode(int i, const Solution &s) {
+        const int depot = _g->depotId();
+        Word *words = _data(i);
+        uint32_t k = 0;
+        for (int r = 0; r < s.routeSlots(); r++) {
+            if (s.routeSize(r) == 0) continue;
+            for (int c = s.first(r); c != depot; c = s.next(c)) words[k++] = (Word) c;
+            words[k++] = (Word) depot;
+        }
+        _length[i] = k;
+        _cost[i] = s.cost();
+        _hash[i] = s.hash();
+    }
+
+    void Population::encode(int i, const std::list<Tour> &tours) {
+        const int depot = _g->depotId();
+        Word *words = _data(i);
+        uint32_t k = 0;
+        double cost = 0;
+        for (const Tour &t : tours) {
+            if (t.cities.empty()) continue;
+            for (int c : t.cities) words[k++] = (Word) c;
+            words[k++] = (Word) depot;
+            cost += t.cost;
+        }
+        _length[i] = k;
+        _cost[i] = cost;
+        _hash[i] = solutionHash(tours);
+    }
+
+    void Population::copy(int i, const Population &other, int j) {
+        assert(other._stride == _stride);
+        memcpy(_data(i), other.data(j), other._length[j] * sizeof(Word));
+        _length[i] = other._length[j];
+        _cost[i] = other._cost[j];
+        _hash[i] = other._hash[j];
+    }
+
+    void Population::decode(int i, Solution &s) const {
+        const int depot = _g->depotId();
+        const Word *words = data(i);
+        s.clear();
+        int r = -1;
+        for (uint32_t k = 0; k < _length[i]; k++) {
+            const int c = words[k];
+            if (c == depot) r = -1;
+            else if (r < 0) r = s.openRoute(c);
+            else s.insertAfter(c, s.last(r), r);
+        }
+    }
+
+    std::list<Tour> Population::decode(int i) const {
+        const int depot = _g->depotId();
+        const Word *words = data(i);
+        std::list<Tour> tours;
+        bool open = false;
+        for (uint32_t k = 0; k < _length[i]; k++) {
+            const int c = words[k];
+            if (c == depot) {
+                open = false;
+                continue;
+            }
+            if (!open) tours.emplace_back();
+            open = true;
+            tours.back().addCity(c, _g->getDemand(c), *_g);
+        }
+        return tours;
+    }
+}
@@ -0,0 +1,88 @@
+#ifndef PMAOA_POPULATION_H
+#define PMAOA_POPULATION_H
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "aligned_array.h"
+#include "graph.h"
+#include "solution.h"
+
+namespace maoa {
+
+    /*!
+     * Fixed-capacity set of solutions in a compact encoding, for the
+     * population-based searches (elite ants, multi-start pools, ...).
+     *
+     * Every solution is stored as a giant tour of 16-bit node ids in which
+     * each route is terminated by the depot id. Its length, up to 2(n-1)
+     * words, is kept aside with its cost and hash. All
+     * the solutions share one cache-aligned buffer with a fixed stride, so a
+     * population of hundreds of solutions is a single allocation of a few
+     * bytes per customer, and copying a solution or a whole population is a
+     * memcpy.
+     *
+     * The encoding needs fewer than 65536 nodes, see supports().
+     */
+    class Population {
+    public:
+        typedef uint16_t Word;
+
+        /*! True if the nodes of \a g fit in the encoding. */
+        static bool supports(const Graph &g) { return g.nodeNum() <= UINT16_MAX; }
+
+        /*!
+         * Creates an empty population.
+         * @param g Graph of the solutions, it must be supported.
+         * @param capacity Maximum number of solutions.
+         */
+        Population(const Graph &g, int capacity);
+
+        const Graph &graph() const { return *_g; }
+        int size() const { return _size; }
+        int capacity() const { return _capacity; }
+        bool full() const { return _size == _capacity; }
+        void clear() { _size = 0; }
+
+        /*! Cost of solution \a i. */
+        double cost(int i) const { return _cost[i]; }
+        /*! Hash of solution \a i, see Solution::hash(). */
+        uint64_t hash(int i) const { return _hash[i]; }
+        /*! Number of routes of solution \a i. */
+        int routeCount(int i) const;
+        /*! Encoded solution \a i: the giant tour, of length(i) words. */
+        const Word *data(int i) const { return _words.data() + (std::size_t) i * _stride; }
+        /*! Number of words of solution \a i. */
+        uint32_t length(int i) const { return _length[i]; }
+
+        /*! Appends a solution to the population, which must not be full.
+         * @return Its index. */
+        int add(const Solution &s);
+        int add(const std::list<Tour> &tours);
+        /*! Overwrites solution \a i. */
+        void encode(int i, const Solution &s);
+        void encode(int i, const std::list<Tour> &tours);
+        /*! Copies solution \a j of \a other, on the same graph, over solution \a i. */
+        void copy(int i, const Population &other, int j);
+
+        /*! Replaces the routes of \a s with those of solution \a i. */
+        void decode(int i, Solution &s) const;
+        /*! Returns the routes of solution \a i, with their load, cost and hash. */
+        std::list<Tour> decode(int i) const;
+
+    private:
+        const Graph *_g;
+        int _capacity, _size;
+        // Words per solution, a whole number of cache lines.
+        std::size_t _stride;
+        AlignedArray<Word> _words;
+        std::vector<uint32_t> _length;
+        std::vector<double> _cost;
+        std::vector<uint64_t> _hash;
+
+        Word *_data(int i) { return _words.data() + (std::size_t) i * _stride; }
+    };
+}
+
+#endif //PMAOA_POPULATION_H
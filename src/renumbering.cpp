@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "renumbering.h"
+
+namespace maoa {
+
+    namespace {
+
+        /*! Number of bits per coordinate of the Hilbert grid. */
+        const int ORDER = 16;
+
+        /*! Position of the cell (cx, cy) along the curve covering a 2^ORDER grid. */
+        uint64_t hilbertIndex(uint32_t cx, uint32_t cy) {
+            uint64_t d = 0;
+            for (uint32_t s = 1u << (ORDER - 1); s > 0; s >>= 1) {
+                const uint32_t rx = (cx & s) ? 1 : 0;
+                const uint32_t ry = (cy & s) ? 1 : 0;
+                d += (uint64_t) s * s * ((3 * rx) ^ ry);
+                // Rotate the quadrant so that the curve stays continuous.
+                if (ry == 0) {
+                    if (rx == 1) {
+                        cx = s - 1 - (cx & (s - 1));
+                        cy = s - 1 - (cy & (s - 1));
+                    }
+                    std::swap(cx, cy);
+                }
+                cx &= s - 1;
+                cy &= s - 1;
+            }
+            return d;
+        }
+    }
+
+    void hilbertOrder(const float *x, const float *y, int n, int depotId, std::vector<int> &order) {
+        order.clear();
+        if (n <= 0) return;
+
+        float minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+        for (int i = 1; i < n; i++) {
+            minX = std::min(minX, x[i]);
+            maxX = std::max(maxX, x[i]);
+            minY = std::min(minY, y[i]);
+            maxY = std::max(maxY, y[i]);
+        }
+        double extent = std::max(maxX - minX, maxY - minY);
+        if (extent <= 0) extent = 1;
+        const double scale = ((1u << ORDER) - 1) / extent;
+
+        std::vector<std::pair<uint64_t, int>> keys;
+        keys.reserve(n);
+        for (int i = 0; i < n; i++) {
+            if (i == depotId) continue;
+            const uint32_t cx = (uint32_t) ((x[i] - minX) * scale);
+            const uint32_t cy = (uint32_t) ((y[i] - minY) * scale);
+            keys.emplace_back(hilbertIndex(cx, cy), i);
+        }
+        // Nodes falling in the same cell keep their file order.
+        std::sort(keys.begin(), keys.end());
+
+        order.reserve(n);
+        if (depotId >= 0 && depotId < n) order.push_back(depotId);
+        for (const auto &key : keys) order.push_back(key.second);
+    }
+}
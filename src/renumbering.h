@@ -0,0 +1,23 @@
+#ifndef PMAOA_RENUMBERING_H
+#define PMAOA_RENUMBERING_H
+
+#include <vector>
+
+namespace maoa {
+
+    /*!
+     * Computes an order of the nodes along a Hilbert curve over their bounding
+     * box, so that nodes close in the plane get close ids. Used to renumber
+     * instances whose ids follow file order: rows of the distance matrix and
+     * neighbor lists are then read with much better locality.
+     * @param x Abscissa of each node.
+     * @param y Ordinate of each node.
+     * @param n Number of nodes.
+     * @param depotId Id of the depot, always placed first.
+     * @param order Filled with the n node ids: order[k] is the node that
+     * gets the new id k.
+     */
+    void hilbertOrder(const float *x, const float *y, int n, int depotId, std::vector<int> &order);
+}
+
+#endif //PMAOA_RENUMBERING_H
@@ -0,0 +1,58 @@
+#include <algorithm>
+
+#include "route.h"
+
+namespace maoa {
+
+    Route::Route(int nodeNum) : _position(nodeNum, -1), _load(0) {}
+
+    Route::Route(const Tour &t, int nodeNum) : Route(nodeNum) {
+        assign(t);
+    }
+
+    void Route::assign(const Tour &t) {
+        clear();
+        _cities.assign(t.cities.begin(), t.cities.end());
+        for (int k = 0; k < size(); k++) _position[_cities[k]] = k;
+        _load = t.capacity;
+    }
+
+    Tour Route::toTour() const {
+        Tour t;
+        copyTo(t);
+        return t;
+    }
+
+    void Route::copyTo(Tour &t) const {
+        auto c_it = t.cities.begin();
+        int k = 0;
+        for (; c_it != t.cities.end() && k < size(); c_it++, k++) *c_it = _cities[k];
+        t.cities.erase(c_it, t.cities.end());
+        for (; k < size(); k++) t.cities.push_back(_cities[k]);
+        t.capacity = _load;
+    }
+
+    void Route::reverse(int i, int j) {
+        std::reverse(_cities.begin() + i, _cities.begin() + j + 1);
+        for (int k = i; k <= j; k++) _position[_cities[k]] = k;
+    }
+
+    void Route::insert(int k, int city, float demand) {
+        _cities.insert(_cities.begin() + k, city);
+        for (int p = k; p < size(); p++) _position[_cities[p]] = p;
+        _load += demand;
+    }
+
+    void Route::erase(int k, float demand) {
+        _position[_cities[k]] = -1;
+        _cities.erase(_cities.begin() + k);
+        for (int p = k; p < size(); p++) _position[_cities[p]] = p;
+        _load -= demand;
+    }
+
+    void Route::clear() {
+        for (int city : _cities) _position[city] = -1;
+        _cities.clear();
+        _load = 0;
+    }
+}
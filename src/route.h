@@ -0,0 +1,82 @@
+#ifndef PMAOA_ROUTE_H
+#define PMAOA_ROUTE_H
+
+#include <vector>
+
+#include "graph.h"
+
+namespace maoa {
+
+    /*!
+     * Route stored as a contiguous array of cities, with the position of every
+     * city of the graph in that array. Cities are accessed and located in
+     * O(1), and segments are reversed in place, which is what the intra-route
+     * operators need. The depot is implicit at both ends, as in \p Tour.
+     *
+     * The position index has one entry per node of the graph. assign() only
+     * clears the entries of the previous cities, so a single Route can be
+     * reused for every tour of a solution without reallocating.
+     *
+     * The navigation methods (first(), next(), between(), reversePath(), ...)
+     * are shared with \p TwoLevelRoute, so the operators can be written once
+     * for both representations.
+     */
+    class Route {
+    public:
+        /*!
+         * Creates an empty route.
+         * @param nodeNum Number of nodes of the graph, size of the position index.
+         */
+        explicit Route(int nodeNum = 0);
+        /*! Creates a route with the cities of \a t. */
+        Route(const Tour &t, int nodeNum);
+
+        /*! Replaces the cities of the route with those of \a t. */
+        void assign(const Tour &t);
+        /*! Returns the route as a Tour, with the same load. */
+        Tour toTour() const;
+        /*! Writes the cities back into \a t, reusing its list nodes. */
+        void copyTo(Tour &t) const;
+
+        int size() const { return (int) _cities.size(); }
+        bool empty() const { return _cities.empty(); }
+        /*! City at position \a k. */
+        int operator[](int k) const { return _cities[k]; }
+        /*! Position of \a city in the route, -1 if it does not belong to it. */
+        int position(int city) const { return _position[city]; }
+        bool contains(int city) const { return _position[city] >= 0; }
+        /*! Sum of the demands of the cities. */
+        float load() const { return _load; }
+        const int *data() const { return _cities.data(); }
+
+        /*! First city, -1 if the route is empty. */
+        int first() const { return _cities.empty() ? -1 : _cities.front(); }
+        /*! Last city, -1 if the route is empty. */
+        int last() const { return _cities.empty() ? -1 : _cities.back(); }
+        /*! City after \a c, -1 if \a c is the last one. */
+        int next(int c) const { return _position[c] + 1 < size() ? _cities[_position[c] + 1] : -1; }
+        /*! City before \a c, -1 if \a c is the first one. */
+        int prev(int c) const { return _position[c] > 0 ? _cities[_position[c] - 1] : -1; }
+        /*! True if \a b is on the path from \a a to \a c (both included). */
+        bool between(int a, int b, int c) const {
+            return _position[a] <= _position[b] && _position[b] <= _position[c];
+        }
+        /*! Reverses the path from \a from to \a to, \a from being before \a to. */
+        void reversePath(int from, int to) { reverse(_position[from], _position[to]); }
+
+        /*! Reverses the cities at positions \a i to \a j (both included). */
+        void reverse(int i, int j);
+        /*! Inserts \a city at position \a k, shifting the following ones. */
+        void insert(int k, int city, float demand);
+        /*! Removes the city at position \a k, shifting the following ones. */
+        void erase(int k, float demand);
+        void clear();
+
+    private:
+        std::vector<int> _cities;
+        std::vector<int> _position;
+        float _load;
+    };
+}
+
+#endif //PMAOA_ROUTE_H
@@ -0,0 +1,50 @@
+#include "row_cache.h"
+
+namespace maoa {
+
+    void DistanceRowCache::reset(int n, std::size_t stride, int capacity, RowFunction computeRow) {
+        _n = n;
+        _stride = stride;
+        _computeRow = std::move(computeRow);
+        _slots.resize(stride * capacity);
+        _slotOf.assign(n, -1);
+        _rowOf.assign(capacity, -1);
+        // Initially every slot is free and chained from head to tail.
+        _prev.resize(capacity);
+        _next.resize(capacity);
+        for (int s = 0; s < capacity; s++) {
+            _prev[s] = s - 1;
+            _next[s] = s + 1 < capacity ? s + 1 : -1;
+        }
+        _head = 0;
+        _tail = capacity - 1;
+        _stats = RowCacheStats();
+        _stats.capacity = capacity;
+    }
+
+    const double *DistanceRowCache::_load(int i) {
+        _stats.misses++;
+        // Reuse the least recently used slot.
+        const int slot = _tail;
+        if (_rowOf[slot] >= 0) _slotOf[_rowOf[slot]] = -1;
+        _rowOf[slot] = i;
+        _slotOf[i] = slot;
+        _moveToFront(slot);
+        double *row = _slots.data() + slot * _stride;
+        _computeRow(i, row);
+        return row;
+    }
+
+    void DistanceRowCache::_moveToFront(int slot) {
+        if (slot == _head) return;
+        // Unlink.
+        _next[_prev[slot]] = _next[slot];
+        if (_next[slot] >= 0) _prev[_next[slot]] = _prev[slot];
+        else _tail = _prev[slot];
+        // Insert at head.
+        _prev[slot] = -1;
+        _next[slot] = _head;
+        _prev[_head] = slot;
+        _head = slot;
+    }
+}
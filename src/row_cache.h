@@ -0,0 +1,79 @@
+#ifndef PMAOA_ROW_CACHE_H
+#define PMAOA_ROW_CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "aligned_array.h"
+
+namespace maoa {
+
+    /*! Counters of a \p DistanceRowCache. */
+    struct RowCacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        int capacity = 0; //!< Number of rows the cache can hold.
+    };
+
+    /*!
+     * Least-recently-used cache of distance matrix rows, for instances too
+     * large for a dense matrix. Rows are computed on demand by a callback and
+     * kept in a fixed pool of cache-aligned slots.
+     *
+     * A pointer returned by \p row stays valid until the cache has to compute
+     * capacity() other rows, i.e. at least until the next miss.
+     */
+    class DistanceRowCache {
+    public:
+        typedef std::function<void(int, double *)> RowFunction;
+
+        DistanceRowCache() : _n(0), _stride(0), _head(-1), _tail(-1) {}
+
+        /*!
+         * Allocates the slots and clears the cache.
+         * @param n Number of rows (and columns) of the matrix.
+         * @param stride Distance in elements between two slots.
+         * @param capacity Number of slots, at least 1.
+         * @param computeRow Callback filling a row of n distances.
+         */
+        void reset(int n, std::size_t stride, int capacity, RowFunction computeRow);
+
+        /*! Returns row \a i, computing it if needed. */
+        const double *row(int i) {
+            int slot = _slotOf[i];
+            if (slot >= 0) {
+                _stats.hits++;
+                if (slot != _head) _moveToFront(slot);
+                return _slots.data() + slot * _stride;
+            }
+            return _load(i);
+        }
+
+        /*! Returns row \a i if it is cached, nullptr otherwise. Does not
+         * count as a use of the row. */
+        const double *peek(int i) const {
+            int slot = _slotOf[i];
+            return slot >= 0 ? _slots.data() + slot * _stride : nullptr;
+        }
+
+        const RowCacheStats &stats() const { return _stats; }
+        bool empty() const { return _n == 0; }
+
+    private:
+        int _n;
+        std::size_t _stride;
+        AlignedArray<double> _slots;
+        std::vector<int> _slotOf;    // Slot holding each row, -1 if none.
+        std::vector<int> _rowOf;     // Row held by each slot, -1 if none.
+        std::vector<int> _prev, _next; // LRU list over slots, head is newest.
+        int _head, _tail;
+        RowFunction _computeRow;
+        RowCacheStats _stats;
+
+        const double *_load(int i);
+        void _moveToFront(int slot);
+    };
+}
+
+#endif //PMAOA_ROW_CACHE_H
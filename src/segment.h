@@ -0,0 +1,26 @@
+#ifndef PMAOA_SEGMENT_H
+#define PMAOA_SEGMENT_H
+
+namespace maoa {
+
+    /*!
+     * Summary of a sequence of consecutive nodes of a route: its end nodes,
+     * the sum of the demands and the distance along it. Moves built from
+     * pieces of routes (relocate, swap, 2-opt*, CROSS...) are evaluated by
+     * concatenating segments, each concatenation is O(1). See
+     * Solution::prefix, Solution::suffix and Solution::concat.
+     *
+     * Distances are in evaluation units: plain distances, or integer costs
+     * (exact in a double) when the graph has integer costs.
+     */
+    struct Segment {
+        int first, last;
+        float load;
+        double distance;
+
+        /*! Segment made of the single node \a i. */
+        static Segment node(int i, float demand) { return Segment{i, i, demand, 0}; }
+    };
+}
+
+#endif //PMAOA_SEGMENT_H
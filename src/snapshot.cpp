@@ -0,0 +1,149 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "snapshot.h"
+
+namespace maoa {
+namespace snapshot {
+
+    namespace {
+
+        const char MAGIC[8] = {'P', 'M', 'A', 'O', 'A', 'S', 'N', 'P'};
+        const uint64_t PAGE = 4096;
+
+        /*! Fixed size header at the start of the file. */
+        struct Header {
+            char magic[8];
+            uint32_t version;
+            int32_t dimension;
+            int32_t vehicles;
+            int32_t depotId;
+            float capacity;
+            uint8_t edgeWeightType;
+            uint8_t rounding;
+            uint8_t hasDistances;
+            uint8_t reserved;
+            uint64_t stride;         // Row stride of the matrix, in doubles.
+            uint64_t nodesOffset;    // x[], y[] then demand[], as floats.
+            uint64_t distancesOffset;
+            uint64_t fileSize;
+        };
+
+        uint64_t alignUp(uint64_t v, uint64_t alignment) {
+            return (v + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    bool isSnapshot(const std::string &filename) {
+        const size_t len = strlen(EXTENSION);
+        return filename.size() >= len
+               && filename.compare(filename.size() - len, len, EXTENSION) == 0;
+    }
+
+    bool write(const Graph &g, const std::string &filename, bool withDistances) {
+        const int n = g.nodeNum();
+        const DistanceMatrix<double> &distances = g.distanceMatrix();
+        // Explicit instances have no coordinates, the matrix is mandatory.
+        if (g.edgeWeightType() == EdgeWeightType::Explicit && !g.hasDenseDistances()) return false;
+        // Snapshots are in file order.
+        if (g.isRenumbered()) return false;
+
+        Header h;
+        memset(&h, 0, sizeof(h));
+        memcpy(h.magic, MAGIC, sizeof(MAGIC));
+        h.version = VERSION;
+        h.dimension = n;
+        h.vehicles = g.vehiclesNum();
+        h.depotId = g.depotId();
+        h.capacity = g.capacity();
+        h.edgeWeightType = (uint8_t) g.edgeWeightType();
+        h.rounding = (uint8_t) g.rounding();
+        h.hasDistances = (withDistances && g.hasDenseDistances())
+                         || g.edgeWeightType() == EdgeWeightType::Explicit;
+        h.stride = distances.stride();
+        h.nodesOffset = sizeof(Header);
+        h.distancesOffset = alignUp(h.nodesOffset + 3 * sizeof(float) * n, PAGE);
+        h.fileSize = h.hasDistances ? h.distancesOffset + h.stride * n * sizeof(double)
+                                    : h.nodesOffset + 3 * sizeof(float) * n;
+
+        std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+
+        std::vector<float> nodes(3 * n);
+        for (int i = 0; i < n; i++) {
+            NodeData d = g.getData(i);
+            nodes[i] = d.x;
+            nodes[n + i] = d.y;
+            nodes[2 * n + i] = d.demand;
+        }
+        out.write(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(float));
+
+        if (h.hasDistances) {
+            std::vector<char> padding(h.distancesOffset - h.nodesOffset - nodes.size() * sizeof(float), 0);
+            out.write(padding.data(), padding.size());
+            out.write(reinterpret_cast<const char *>(distances.row(0)), h.stride * n * sizeof(double));
+        }
+        return (bool) out;
+    }
+
+    ParseStatus load(const std::string &filename, InstanceData &data) {
+        data = InstanceData();
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return ParseStatus::CannotOpen;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            return ParseStatus::CannotOpen;
+        }
+        const uint64_t size = (uint64_t) st.st_size;
+        if (size < sizeof(Header)) {
+            close(fd);
+            return ParseStatus::BadSnapshot;
+        }
+
+        // A shared read-only mapping lets every process use the same pages.
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return ParseStatus::CannotOpen;
+        std::shared_ptr<char> mapping(static_cast<char *>(mapped), [size](char *p) { munmap(p, size); });
+
+        Header h;
+        memcpy(&h, mapping.get(), sizeof(h));
+        const uint64_t n = h.dimension > 0 ? (uint64_t) h.dimension : 0;
+        if (memcmp(h.magic, MAGIC, sizeof(MAGIC)) != 0 || h.version != VERSION || n == 0
+                || h.fileSize != size || h.nodesOffset + 3 * sizeof(float) * n > size
+                || h.depotId < 0 || (uint64_t) h.depotId >= n
+                || (h.hasDistances && (h.stride < n || h.distancesOffset % PAGE != 0
+                                       || h.distancesOffset + h.stride * n * sizeof(double) > size))) {
+            return ParseStatus::BadSnapshot;
+        }
+
+        data.dimension = h.dimension;
+        data.vehicles = h.vehicles;
+        data.depotId = h.depotId;
+        data.capacity = h.capacity;
+        data.edgeWeightType = (EdgeWeightType) h.edgeWeightType;
+
+        const float *nodes = reinterpret_cast<const float *>(mapping.get() + h.nodesOffset);
+        data.x.assign(nodes, nodes + n);
+        data.y.assign(nodes + n, nodes + 2 * n);
+        data.demand.assign(nodes + 2 * n, nodes + 3 * n);
+
+        if (h.hasDistances) {
+            madvise(mapping.get() + h.distancesOffset, h.stride * n * sizeof(double), MADV_WILLNEED);
+            double *rows = reinterpret_cast<double *>(mapping.get() + h.distancesOffset);
+            data.distances = DistanceMatrix<double>(std::shared_ptr<double>(mapping, rows), h.dimension, h.stride);
+            data.distancesRounding = (Rounding) h.rounding;
+        }
+        return ParseStatus::Ok;
+    }
+}
+}
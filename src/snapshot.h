@@ -0,0 +1,58 @@
+#ifndef PMAOA_SNAPSHOT_H
+#define PMAOA_SNAPSHOT_H
+
+#include <string>
+
+#include "graph.h"
+#include "vrp_parser.h"
+
+namespace maoa {
+
+    /*!
+     * Binary snapshots of parsed instances.
+     *
+     * A snapshot holds the node coordinates and demands, the capacity, the
+     * number of vehicles, the depot and optionally the precomputed distance
+     * matrix. The matrix is stored page-aligned with the row stride of
+     * \p DistanceMatrix, so that it can be used in place from a read-only
+     * shared mapping: solver processes loading the same snapshot share one
+     * physical copy of it through the page cache.
+     *
+     * The layout uses the native byte order of the machine that wrote it.
+     */
+    namespace snapshot {
+
+        /*! Current version of the format, bumped on every layout change. */
+        const unsigned VERSION = 1;
+
+        /*! Extension recognised by \p Graph to load a snapshot. */
+        const char *const EXTENSION = ".snap";
+
+        /*!
+         * Writes a snapshot of \a g.
+         * @param g Graph to save.
+         * @param filename Path of the snapshot file.
+         * @param withDistances If true the distance matrix is stored as well
+         * (only possible when \a g has dense distances).
+         * @return true on success, false if the file could not be written or
+         * if \a g is an EXPLICIT instance without its double matrix or is
+         * renumbered.
+         */
+        bool write(const Graph &g, const std::string &filename, bool withDistances = true);
+
+        /*!
+         * Maps a snapshot read-only. Coordinates and demands are copied into
+         * \a data, the distance matrix (if present) points into the mapping,
+         * which stays alive as long as a copy of \p InstanceData::distances.
+         * @param filename Path of the snapshot file.
+         * @param data Structure filled with the instance.
+         * @return ParseStatus::Ok on success, the cause of the failure otherwise.
+         */
+        ParseStatus load(const std::string &filename, InstanceData &data);
+
+        /*! Returns true if \a filename has the snapshot extension. */
+        bool isSnapshot(const std::string &filename);
+    }
+}
+
+#endif //PMAOA_SNAPSHOT_H
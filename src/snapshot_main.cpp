@@ -0,0 +1,40 @@
+#include <cstring>
+
+#include "graph.h"
+#include "snapshot.h"
+
+int main(int argc, char** argv) {
+    if (argc <= 2) {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "\tsnapshot <instance> <output.snap> [options]" << std::endl;
+        std::cout << "Options:" << std::endl;
+        std::cout << "\t-nodist\t Do not store the distance matrix" << std::endl;
+        std::cout << "\t-nint\t Round distances to the nearest integer (TSPLIB)" << std::endl;
+        exit(1);
+    }
+
+    string inputPath{argv[1]};
+    string outputPath{argv[2]};
+    bool withDistances = true;
+    maoa::LoadOptions options;
+
+    for (int i = 3; i < argc; i++) {
+        if (strncmp(argv[i], "-nodist", 7) == 0) {
+            withDistances = false;
+        }
+        if (strncmp(argv[i], "-nint", 5) == 0) {
+            options.rounding = maoa::Rounding::Nint;
+        }
+    }
+
+    if (!maoa::snapshot::isSnapshot(outputPath)) {
+        std::cerr << "Output file must have the " << maoa::snapshot::EXTENSION << " extension" << std::endl;
+        exit(1);
+    }
+
+    maoa::Graph g(inputPath, options);
+    if (!maoa::snapshot::write(g, outputPath, withDistances)) {
+        std::cerr << "Unable to write file : " << outputPath << std::endl;
+        exit(1);
+    }
+}
@@ -0,0 +1,301 @@
+#include <cmath>
+
+#include "solution.h"
+
+namespace maoa {
+
+    Solution::Solution(const Graph &g)
+            : _g(&g), _depot(g.depotId()),
+              _next(g.nodeNum()), _prev(g.nodeNum()), _routeOf(g.nodeNum()), _pos(g.nodeNum()),
+              _prefixLoad(g.nodeNum()), _prefixDistance(g.nodeNum()),
+              _first(g.nodeNum()), _last(g.nodeNum()), _size(g.nodeNum()),
+              _load(g.nodeNum()), _cost(g.nodeNum()), _hash(g.nodeNum()) {
+        clear();
+    }
+
+    Solution::Solution(const Graph &g, const std::list<Tour> &tours) : Solution(g) {
+        assign(tours);
+    }
+
+    void Solution::clear() {
+        std::fill(_next.begin(), _next.end(), -1);
+        std::fill(_prev.begin(), _prev.end(), -1);
+        std::fill(_routeOf.begin(), _routeOf.end(), -1);
+        std::fill(_pos.begin(), _pos.end(), -1);
+        _routeSlots = 0;
+        _totalCost = 0;
+        _solutionHash = 0;
+    }
+
+    void Solution::assign(const std::list<Tour> &tours) {
+        clear();
+        for (const Tour &t : tours) {
+            const int r = _routeSlots++;
+            _first[r] = _last[r] = _depot;
+            _size[r] = 0;
+            _load[r] = 0;
+            _cost[r] = 0;
+            _hash[r] = 0;
+            for (int city : t.cities) insertAfter(city, _last[r], r);
+        }
+    }
+
+    std::list<Tour> Solution::toTours() const {
+        std::list<Tour> tours;
+        for (int r = 0; r < _routeSlots; r++) {
+            if (_size[r] == 0) continue;
+            tours.emplace_back();
+            Tour &t = tours.back();
+            for (int c = _first[r]; c != _depot; c = _next[c]) t.cities.push_back(c);
+            t.capacity = _load[r];
+            t.cost = _cost[r];
+            t.hash = _hash[r];
+        }
+        return tours;
+    }
+
+    int Solution::routeCount() const {
+        int count = 0;
+        for (int r = 0; r < _routeSlots; r++) {
+            if (_size[r] > 0) count++;
+        }
+        return count;
+    }
+
+    int Solution::openRoute(int city) {
+        int r = _routeSlots;
+        if (r < (int) _first.size()) {
+            _routeSlots++;
+        } else {
+            // Every slot was used once, take an empty one.
+            for (r = 0; _size[r] > 0; r++);
+        }
+        _first[r] = _last[r] = _depot;
+        _size[r] = 0;
+        _load[r] = 0;
+        _cost[r] = 0;
+        _hash[r] = 0;
+        insertAfter(city, _depot, r);
+        return r;
+    }
+
+    void Solution::concatenate(int r1, int r2) {
+        if (_size[r2] == 0 || r1 == r2) return;
+        const int first2 = _first[r2];
+        double joined = _cost[r2];
+        uint64_t joinedHash = _hash[r1] + _hash[r2];
+        if (_size[r1] == 0) {
+            _first[r1] = first2;
+        } else {
+            const int last1 = _last[r1];
+            joined += _d(last1, first2) - _d(last1, _depot) - _d(_depot, first2);
+            joinedHash += _key(last1, first2) - _key(last1, _depot) - _key(_depot, first2);
+            _next[last1] = first2;
+            _prev[first2] = last1;
+        }
+        _last[r1] = _last[r2];
+        for (int c = first2; c != _depot; c = _next[c]) _routeOf[c] = r1;
+        _size[r1] += _size[r2];
+        _load[r1] += _load[r2];
+        _renumber(first2);
+        _addCost(r1, joined);
+        _addCost(r2, -_cost[r2]);
+        _setHash(r1, joinedHash);
+        _setHash(r2, 0);
+        _first[r2] = _last[r2] = _depot;
+        _size[r2] = 0;
+        _load[r2] = 0;
+    }
+
+    void Solution::insertAfter(int city, int pred, int r) {
+        const int succ = (pred == _depot) ? _first[r] : _next[pred];
+        _addCost(r, _d(pred, city) + _d(city, succ) - _d(pred, succ));
+        // An empty route has hash 0, not the key of a (depot, depot) edge.
+        _setHash(r, _size[r] == 0 ? 2 * _key(_depot, city)
+                                  : _hash[r] + _key(pred, city) + _key(city, succ) - _key(pred, succ));
+        _prev[city] = pred;
+        _next[city] = succ;
+        if (pred == _depot) _first[r] = city;
+        else _next[pred] = city;
+        if (succ == _depot) _last[r] = city;
+        else _prev[succ] = city;
+        _routeOf[city] = r;
+        _size[r]++;
+        _load[r] += _g->getDemand(city);
+        _renumber(city);
+    }
+
+    void Solution::remove(int city) {
+        const int r = _routeOf[city];
+        const int pred = _prev[city], succ = _next[city];
+        _addCost(r, _d(pred, succ) - _d(pred, city) - _d(city, succ));
+        _setHash(r, _size[r] == 1 ? 0 : _hash[r] + _key(pred, succ) - _key(pred, city) - _key(city, succ));
+        if (pred == _depot) _first[r] = succ;
+        else _next[pred] = succ;
+        if (succ == _depot) _last[r] = pred;
+        else _prev[succ] = pred;
+        _next[city] = _prev[city] = -1;
+        _routeOf[city] = -1;
+        _pos[city] = -1;
+        _size[r]--;
+        _load[r] -= _g->getDemand(city);
+        // Keep the cost of an empty route at exactly 0.
+        if (_size[r] == 0) _addCost(r, -_cost[r]);
+        _renumber(succ);
+    }
+
+    void Solution::relocate(int city, int pred, int r) {
+        remove(city);
+        insertAfter(city, pred, r);
+    }
+
+    void Solution::exchange(int a, int b) {
+        const int ra = _routeOf[a], rb = _routeOf[b];
+        const int pa = _prev[a], na = _next[a];
+        const int pb = _prev[b], nb = _next[b];
+        _addCost(ra, _d(pa, b) + _d(b, na) - _d(pa, a) - _d(a, na));
+        _addCost(rb, _d(pb, a) + _d(a, nb) - _d(pb, b) - _d(b, nb));
+        _setHash(ra, _hash[ra] + _key(pa, b) + _key(b, na) - _key(pa, a) - _key(a, na));
+        _setHash(rb, _hash[rb] + _key(pb, a) + _key(a, nb) - _key(pb, b) - _key(b, nb));
+
+        // b takes the place of a.
+        _prev[b] = pa;
+        _next[b] = na;
+        if (pa == _depot) _first[ra] = b;
+        else _next[pa] = b;
+        if (na == _depot) _last[ra] = b;
+        else _prev[na] = b;
+        // a takes the place of b.
+        _prev[a] = pb;
+        _next[a] = nb;
+        if (pb == _depot) _first[rb] = a;
+        else _next[pb] = a;
+        if (nb == _depot) _last[rb] = a;
+        else _prev[nb] = a;
+
+        std::swap(_routeOf[a], _routeOf[b]);
+        const float delta = _g->getDemand(b) - _g->getDemand(a);
+        _load[ra] += delta;
+        _load[rb] -= delta;
+        _renumber(b);
+        _renumber(a);
+    }
+
+    void Solution::swapTails(int a, int ra, int b, int rb) {
+        const int tailA = (a == _depot) ? _first[ra] : _next[a];
+        const int tailB = (b == _depot) ? _first[rb] : _next[b];
+        const int lastA = _last[ra], lastB = _last[rb];
+        int sizeA = 0, sizeB = 0;
+        float loadA = 0, loadB = 0;
+        for (int c = tailA; c != _depot; c = _next[c]) {
+            _routeOf[c] = rb;
+            sizeA++;
+            loadA += _g->getDemand(c);
+        }
+        for (int c = tailB; c != _depot; c = _next[c]) {
+            _routeOf[c] = ra;
+            sizeB++;
+            loadB += _g->getDemand(c);
+        }
+
+        // a is followed by the tail of b.
+        if (a == _depot) _first[ra] = tailB;
+        else _next[a] = tailB;
+        if (tailB == _depot) _last[ra] = a;
+        else {
+            _prev[tailB] = a;
+            _last[ra] = lastB;
+        }
+        // b is followed by the tail of a.
+        if (b == _depot) _first[rb] = tailA;
+        else _next[b] = tailA;
+        if (tailA == _depot) _last[rb] = b;
+        else {
+            _prev[tailA] = b;
+            _last[rb] = lastA;
+        }
+
+        _size[ra] += sizeB - sizeA;
+        _size[rb] += sizeA - sizeB;
+        _load[ra] += loadB - loadA;
+        _load[rb] += loadA - loadB;
+        _renumber(tailB);
+        _renumber(tailA);
+        _recompute(ra);
+        _recompute(rb);
+    }
+
+    void Solution::_recompute(int r) {
+        double cost = 0;
+        uint64_t hash = 0;
+        if (_size[r] > 0) {
+            int pred = _depot;
+            for (int c = _first[r]; c != _depot; c = _next[c]) {
+                cost += _d(pred, c);
+                hash += _key(pred, c);
+                pred = c;
+            }
+            cost += _d(pred, _depot);
+            hash += _key(pred, _depot);
+        }
+        _addCost(r, cost - _cost[r]);
+        _setHash(r, hash);
+    }
+
+    void Solution::_renumber(int from) {
+        if (from == _depot) return;
+        int pred = _prev[from];
+        int k = 0;
+        float load = 0;
+        double distance = 0;
+        if (pred != _depot) {
+            k = _pos[pred] + 1;
+            load = _prefixLoad[pred];
+            distance = _prefixDistance[pred];
+        }
+        for (int c = from; c != _depot; c = _next[c]) {
+            _pos[c] = k++;
+            load += _g->getDemand(c);
+            distance += _e(pred, c);
+            _prefixLoad[c] = load;
+            _prefixDistance[c] = distance;
+            pred = c;
+        }
+    }
+
+    bool Solution::isConsistent(double tolerance) const {
+        double total = 0;
+        uint64_t totalHash = 0;
+        for (int r = 0; r < _routeSlots; r++) {
+            int size = 0;
+            float load = 0;
+            double cost = 0, distance = 0;
+            uint64_t hash = 0;
+            int pred = _depot;
+            for (int c = _first[r]; c != _depot; c = _next[c]) {
+                if (_routeOf[c] != r || _prev[c] != pred || _pos[c] != size) return false;
+                load += _g->getDemand(c);
+                cost += _d(pred, c);
+                distance += _e(pred, c);
+                hash += _key(pred, c);
+                if (std::fabs(_prefixLoad[c] - load) > tolerance * std::max(1.0f, load)
+                        || std::fabs(_prefixDistance[c] - distance) > tolerance * std::max(1.0, distance)) {
+                    return false;
+                }
+                pred = c;
+                size++;
+            }
+            if (size > 0) {
+                cost += _d(pred, _depot);
+                hash += _key(pred, _depot);
+            }
+            if (_hash[r] != hash) return false;
+            totalHash += zobrist::routeContribution(hash);
+            if (_last[r] != pred || _size[r] != size) return false;
+            if (std::fabs(_load[r] - load) > tolerance * std::max(1.0f, load)) return false;
+            if (std::fabs(_cost[r] - cost) > tolerance * std::max(1.0, cost)) return false;
+            total += cost;
+        }
+        return _solutionHash == totalHash && std::fabs(_totalCost - total) <= tolerance * std::max(1.0, total);
+    }
+}
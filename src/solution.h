@@ -0,0 +1,182 @@
+#ifndef PMAOA_SOLUTION_H
+#define PMAOA_SOLUTION_H
+
+#include <list>
+#include <vector>
+
+#include "graph.h"
+#include "segment.h"
+
+/*! Debug check of a Solution after a move, see MAOA_CHECK_TOUR_COST. */
+#ifdef MAOA_DEBUG_CHECKS
+#define MAOA_CHECK_SOLUTION(s) assert((s).isConsistent())
+#else
+#define MAOA_CHECK_SOLUTION(s) ((void) 0)
+#endif
+
+namespace maoa {
+
+    /*!
+     * Set of routes stored as flat arrays over the nodes of the graph: the
+     * successor, predecessor, route and position of every customer, plus the
+     * first and last city, size, load and cost of every route. Every query is
+     * O(1), and moves only touch the arrays (positions are renumbered along
+     * the routes they change, with the segment data), they never allocate.
+     *
+     * The depot is implicit at both ends of every route: next() of the last
+     * city and prev() of the first city are the depot. Customers that belong
+     * to no route have routeOf() == -1.
+     *
+     * Routes are identified by slots in [0, routeSlots()). A route emptied by
+     * a move keeps its slot, openRoute() reuses it later.
+     */
+    class Solution {
+    public:
+        /*! Creates a solution where no customer is routed. */
+        explicit Solution(const Graph &g);
+        /*! Creates a solution with the cities of \a tours, one route per tour. */
+        Solution(const Graph &g, const std::list<Tour> &tours);
+
+        /*! Unroutes every customer and removes every route. */
+        void clear();
+        /*! Replaces the routes with those of \a tours, in the same order. */
+        void assign(const std::list<Tour> &tours);
+        /*! Returns the non-empty routes, in slot order, with their load and cost. */
+        std::list<Tour> toTours() const;
+
+        const Graph &graph() const { return *_g; }
+        int depot() const { return _depot; }
+
+        int next(int i) const { return _next[i]; }
+        int prev(int i) const { return _prev[i]; }
+        int routeOf(int i) const { return _routeOf[i]; }
+        int posInRoute(int i) const { return _pos[i]; }
+        bool isRouted(int i) const { return _routeOf[i] >= 0; }
+
+        /*! Number of route slots, including empty routes. */
+        int routeSlots() const { return _routeSlots; }
+        /*! First city of route \a r, the depot if it is empty. */
+        int first(int r) const { return _first[r]; }
+        /*! Last city of route \a r, the depot if it is empty. */
+        int last(int r) const { return _last[r]; }
+        int routeSize(int r) const { return _size[r]; }
+        float routeLoad(int r) const { return _load[r]; }
+        double routeCost(int r) const { return _cost[r]; }
+        /*! Sum of the route costs. */
+        double cost() const { return _totalCost; }
+        /*! Direction independent hash of route \a r, see zobrist.h. */
+        uint64_t routeHash(int r) const { return _hash[r]; }
+        /*! Hash of the solution, independent of the order of the routes. It
+         * is equal to solutionHash() of toTours(). */
+        uint64_t hash() const { return _solutionHash; }
+        /*! Number of non-empty routes. */
+        int routeCount() const;
+
+        /*!
+         * Segment data, see segment.h. Prefixes and suffixes include the depot
+         * at their route end, so that a complete route is the concatenation
+         * of a prefix and a suffix. Every query is O(1).
+         */
+        /*! From the depot to \a i included (the depot alone if \a i is the depot). */
+        Segment prefix(int i) const {
+            if (i == _depot) return depotSegment();
+            return Segment{_depot, i, _prefixLoad[i], _prefixDistance[i]};
+        }
+        /*! From \a i included to the depot (the depot alone if \a i is the depot). */
+        Segment suffix(int i) const {
+            if (i == _depot) return depotSegment();
+            const int r = _routeOf[i];
+            return Segment{i, _depot, _load[r] - _prefixLoad[i] + _g->getDemand(i),
+                           routeDistance(r) - _prefixDistance[i]};
+        }
+        /*! From \a i to \a j included, two customers of the same route with \a i first. */
+        Segment segment(int i, int j) const {
+            return Segment{i, j, _prefixLoad[j] - _prefixLoad[i] + _g->getDemand(i),
+                           _prefixDistance[j] - _prefixDistance[i]};
+        }
+        /*! Segment made of customer \a i. */
+        Segment node(int i) const { return Segment::node(i, _g->getDemand(i)); }
+        Segment depotSegment() const { return Segment::node(_depot, 0); }
+        /*! Concatenation of \a a and \a b, in this order. */
+        Segment concat(const Segment &a, const Segment &b) const {
+            return Segment{a.first, b.last, a.load + b.load, a.distance + _e(a.last, b.first) + b.distance};
+        }
+        Segment concat(const Segment &a, const Segment &b, const Segment &c) const {
+            return concat(concat(a, b), c);
+        }
+        /*! Distance of route \a r in evaluation units (see segment.h). */
+        double routeDistance(int r) const {
+            return _size[r] == 0 ? 0 : _prefixDistance[_last[r]] + _e(_last[r], _depot);
+        }
+
+        /*!
+         * Creates a route made of the unrouted customer \a city.
+         * @return The slot of the new route.
+         */
+        int openRoute(int city);
+        /*! Appends the cities of route \a r2 at the end of route \a r1, \a r2
+         * becomes empty. */
+        void concatenate(int r1, int r2);
+        /*!
+         * Inserts the unrouted customer \a city in route \a r, after \a pred
+         * which is either a city of \a r or the depot (front of the route).
+         */
+        void insertAfter(int city, int pred, int r);
+        /*! Removes \a city from its route, it becomes unrouted. */
+        void remove(int city);
+        /*! Moves \a city after \a pred in route \a r (same meaning as insertAfter). */
+        void relocate(int city, int pred, int r);
+        /*! Exchanges two customers of different routes. */
+        void exchange(int a, int b);
+        /*!
+         * Exchanges the tails of two different routes: the cities after \a a
+         * in route \a ra go after \a b in route \a rb, and conversely. \a a
+         * and \a b are cities of their route, or the depot to exchange the
+         * whole route. A route may become empty.
+         */
+        void swapTails(int a, int ra, int b, int rb);
+
+        /*!
+         * Debug check: verifies the links, positions, sizes, loads and costs
+         * of every route against a full recomputation.
+         */
+        bool isConsistent(double tolerance = 1e-6) const;
+
+    private:
+        const Graph *_g;
+        int _depot;
+        // Per node.
+        std::vector<int> _next, _prev, _routeOf, _pos;
+        std::vector<float> _prefixLoad;
+        std::vector<double> _prefixDistance;
+        // Per route slot.
+        std::vector<int> _first, _last, _size;
+        std::vector<float> _load;
+        std::vector<double> _cost;
+        std::vector<uint64_t> _hash;
+        int _routeSlots;
+        double _totalCost;
+        uint64_t _solutionHash;
+
+        // Updates the positions and prefix data from node `from` to the end of its route.
+        void _renumber(int from);
+        // Recomputes the cost and hash of route `r` from its cities.
+        void _recompute(int r);
+        /*! Distance in evaluation units. */
+        double _e(int i, int j) const {
+            return _g->hasIntegerCosts() ? _g->intDistance(i, j) : _g->getDistance(i, j);
+        }
+        void _addCost(int r, double delta) {
+            _cost[r] += delta;
+            _totalCost += delta;
+        }
+        double _d(int i, int j) const { return _g->getDistance(i, j); }
+        uint64_t _key(int i, int j) const { return _g->edgeKey(i, j); }
+        void _setHash(int r, uint64_t hash) {
+            _solutionHash += zobrist::routeContribution(hash) - zobrist::routeContribution(_hash[r]);
+            _hash[r] = hash;
+        }
+    };
+}
+
+#endif //PMAOA_SOLUTION_H
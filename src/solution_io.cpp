@@ -0,0 +1,109 @@
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include "solution_io.h"
+
+namespace maoa {
+namespace sol {
+
+    const char *validationStatusMessage(ValidationStatus status) {
+        switch (status) {
+            case ValidationStatus::Valid: return "valid";
+            case ValidationStatus::UnknownNode: return "depot or unknown node in a route";
+            case ValidationStatus::DuplicateCustomer: return "customer visited more than once";
+            case ValidationStatus::MissingCustomer: return "customer not visited";
+            case ValidationStatus::OverCapacity: return "route over capacity";
+            case ValidationStatus::TooManyRoutes: return "more routes than vehicles";
+        }
+        return "unknown error";
+    }
+
+    ValidationStatus validate(const Graph &g, const std::list<Tour> &tours, double *cost) {
+        const int depotId = g.depotId();
+        std::vector<char> visited(g.nodeNum(), 0);
+        int visitedCount = 0;
+        int routes = 0;
+        double total = 0;
+
+        for (const Tour &t : tours) {
+            if (t.cities.empty()) continue;
+            routes++;
+            float load = 0;
+            int prev = depotId;
+            for (int c : t.cities) {
+                if (c < 0 || c >= g.nodeNum() || c == depotId) return ValidationStatus::UnknownNode;
+                if (visited[c]) return ValidationStatus::DuplicateCustomer;
+                visited[c] = 1;
+                visitedCount++;
+                load += g.getDemand(c);
+                total += g.getDistance(prev, c);
+                prev = c;
+            }
+            total += g.getDistance(prev, depotId);
+            if (load > g.capacity()) return ValidationStatus::OverCapacity;
+        }
+        if (cost) *cost = total;
+        if (visitedCount != g.nodeNum() - 1) return ValidationStatus::MissingCustomer;
+        if (routes > g.vehiclesNum()) return ValidationStatus::TooManyRoutes;
+        return ValidationStatus::Valid;
+    }
+
+    void write(const Graph &g, const std::list<Tour> &tours, std::ostream &out) {
+        double cost = 0;
+        int k = 1;
+        for (const Tour &t : tours) {
+            if (t.cities.empty()) continue;
+            out << "Route #" << k++ << ":";
+            for (int c : t.cities) out << " " << g.originalId(c);
+            out << "\n";
+            cost += t.computeCost(g);
+        }
+        out << "cost " << std::setprecision(15) << cost << "\n";
+    }
+
+    bool write(const Graph &g, const std::list<Tour> &tours, const std::string &filename) {
+        std::ofstream out(filename);
+        if (!out) return false;
+        write(g, tours, out);
+        return (bool) out;
+    }
+
+    ParseStatus read(const Graph &g, std::istream &in, std::list<Tour> &tours, double *cost) {
+        tours.clear();
+        if (cost) *cost = -1;
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream words(line);
+            std::string keyword;
+            if (!(words >> keyword)) continue;
+
+            if (keyword == "Route") {
+                const std::string::size_type colon = line.find(':');
+                if (colon == std::string::npos) return ParseStatus::BadNumber;
+                std::istringstream ids(line.substr(colon + 1));
+                tours.emplace_back();
+                int id;
+                while (ids >> id) {
+                    if (id < 0 || id >= g.nodeNum()) return ParseStatus::NodeOutOfRange;
+                    const int c = g.internalId(id);
+                    tours.back().addCity(c, g.getDemand(c), g);
+                }
+                if (!ids.eof()) return ParseStatus::BadNumber;
+            } else if (keyword == "cost" || keyword == "Cost") {
+                double value;
+                if (!(words >> value)) return ParseStatus::BadNumber;
+                if (cost) *cost = value;
+            }
+        }
+        return ParseStatus::Ok;
+    }
+
+    ParseStatus read(const Graph &g, const std::string &filename, std::list<Tour> &tours, double *cost) {
+        std::ifstream in(filename);
+        if (!in) return ParseStatus::CannotOpen;
+        return read(g, in, tours, cost);
+    }
+}
+}
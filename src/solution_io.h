@@ -0,0 +1,68 @@
+#ifndef PMAOA_SOLUTION_IO_H
+#define PMAOA_SOLUTION_IO_H
+
+#include <iostream>
+#include <list>
+#include <string>
+
+#include "graph.h"
+#include "vrp_parser.h"
+
+namespace maoa {
+
+    /*!
+     * Solutions in the CVRPLIB .sol format:
+     *
+     *     Route #1: 21 31 19 17 13 7 26
+     *     ...
+     *     cost 784
+     *
+     * Customers are numbered as in the instance file minus one, without the
+     * depot, which is Graph::originalId() on the node ids of the graph.
+     */
+    namespace sol {
+
+        /*! Result of the validation of a solution. */
+        enum class ValidationStatus {
+            Valid,
+            UnknownNode,      //!< A city is the depot or not a node of the graph.
+            DuplicateCustomer,//!< A customer is visited more than once.
+            MissingCustomer,  //!< A customer is not visited.
+            OverCapacity,     //!< The load of a route exceeds the capacity.
+            TooManyRoutes     //!< More non-empty routes than vehicles.
+        };
+
+        /*! Returns a human readable description of \a status. */
+        const char *validationStatusMessage(ValidationStatus status);
+
+        /*!
+         * Checks in one O(n) pass that every customer is visited exactly
+         * once, that the routes respect the capacity (from the demands, not
+         * Tour::capacity) and that there are at most Graph::vehiclesNum()
+         * non-empty routes.
+         * @param cost If not null, receives the cost recomputed from the graph,
+         * unless a route is invalid.
+         */
+        ValidationStatus validate(const Graph &g, const std::list<Tour> &tours, double *cost = nullptr);
+
+        /*! Writes \a tours to \a out, with their recomputed cost. Empty tours are skipped. */
+        void write(const Graph &g, const std::list<Tour> &tours, std::ostream &out);
+        /*! Writes \a tours to \a filename, see above.
+         * @return false if the file could not be written. */
+        bool write(const Graph &g, const std::list<Tour> &tours, const std::string &filename);
+
+        /*!
+         * Reads a solution of the instance of \a g. The tours get their load,
+         * cost and hash from the graph. Lines other than routes and cost are
+         * ignored.
+         * @param cost If not null, receives the cost line, -1 if there is none.
+         * @return ParseStatus::Ok on success, CannotOpen, BadNumber or
+         * NodeOutOfRange otherwise.
+         */
+        ParseStatus read(const Graph &g, std::istream &in, std::list<Tour> &tours, double *cost = nullptr);
+        ParseStatus read(const Graph &g, const std::string &filename, std::list<Tour> &tours,
+                         double *cost = nullptr);
+    }
+}
+
+#endif //PMAOA_SOLUTION_IO_H
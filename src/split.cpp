@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+#include <lemon/christofides_tsp.h>
+#include <lemon/opt2_tsp.h>
+
+#include "cost.h"
+#include "split.h"
+
+namespace maoa {
+namespace split {
+
+namespace {
+
+    /*
+     * Customers are indexed from 1 to n in the order of the giant tour, index
+     * 0 standing for the depot. With D the distance along the giant tour and
+     * Q the load up to each customer, the route made of the customers i + 1
+     * to j costs
+     *     d(depot, i + 1) + D[j] - D[i + 1] + d(j, depot)
+     * and is feasible if Q[j] - Q[i] <= capacity. The part that depends on i,
+     *     p[i] + d(depot, i + 1) - D[i + 1],
+     * is what the deque orders, p[i] being the cost of the best split of the
+     * first i customers.
+     */
+    template <typename Cost>
+    class Splitter {
+    public:
+        typedef typename Cost::value_type value_type;
+
+        Splitter(const Graph &g, const std::vector<int> &giantTour)
+                : _g(g), _tour(giantTour), _n((int) giantTour.size()),
+                  _fromDepot(_n + 1), _toDepot(_n + 1), _distance(_n + 1), _load(_n + 1) {
+            const int depotId = g.depotId();
+            _distance[0] = _distance[1] = 0;
+            _load[0] = 0;
+            for (int i = 1; i <= _n; i++) {
+                const int c = _tour[i - 1];
+                _fromDepot[i] = Cost::distance(g, depotId, c);
+                _toDepot[i] = Cost::distance(g, c, depotId);
+                _load[i] = _load[i - 1] + g.getDemand(c);
+                if (i > 1) _distance[i] = _distance[i - 1] + Cost::distance(g, _tour[i - 2], c);
+            }
+        }
+
+        /*! One layer of the DP: the best split of every prefix given the
+         * best splits `previous` with one route less (or the same layer). */
+        void layer(const std::vector<value_type> &previous, std::vector<value_type> &p, std::vector<int> &pred,
+                   bool sameLayer) {
+            std::deque<int> window;
+            p[0] = sameLayer ? 0 : INFINITE;
+            for (int t = 1; t <= _n; t++) {
+                const int i = t - 1;
+                const std::vector<value_type> &from = sameLayer ? p : previous;
+                if (from[i] < INFINITE) {
+                    while (!window.empty() && _start(from, window.back()) >= _start(from, i)) window.pop_back();
+                    window.push_back(i);
+                }
+                while (!window.empty() && _load[t] - _load[window.front()] > _g.capacity()) window.pop_front();
+                if (window.empty()) {
+                    p[t] = INFINITE;
+                    pred[t] = -1;
+                } else {
+                    p[t] = _start(from, window.front()) + _distance[t] + _toDepot[t];
+                    pred[t] = window.front();
+                }
+            }
+        }
+
+        /*! Routes of the split ending at customer n, following `pred`. */
+        std::list<Tour> routes(const std::vector<std::vector<int>> &pred, int k) const {
+            std::list<Tour> tours;
+            int t = _n;
+            while (t > 0) {
+                const int i = pred[k][t];
+                tours.emplace_front();
+                for (int j = i + 1; j <= t; j++) {
+                    tours.front().addCity(_tour[j - 1], _g.getDemand(_tour[j - 1]), _g);
+                }
+                t = i;
+                if (k > 0) k--;
+            }
+            return tours;
+        }
+
+        int size() const { return _n; }
+
+        static constexpr value_type INFINITE = std::numeric_limits<value_type>::max();
+
+    private:
+        const Graph &_g;
+        const std::vector<int> &_tour;
+        const int _n;
+        std::vector<value_type> _fromDepot, _toDepot, _distance;
+        std::vector<float> _load;
+
+        value_type _start(const std::vector<value_type> &p, int i) const {
+            return p[i] + _fromDepot[i + 1] - _distance[i + 1];
+        }
+    };
+
+    template <typename Cost>
+    constexpr typename Cost::value_type Splitter<Cost>::INFINITE;
+
+    template <typename Cost>
+    std::list<Tour> split(const Graph &g, const std::vector<int> &giantTour, int maxRoutes) {
+        typedef typename Cost::value_type value_type;
+        Splitter<Cost> splitter(g, giantTour);
+        const int n = splitter.size();
+        if (n == 0) return std::list<Tour>();
+
+        if (maxRoutes <= 0 || maxRoutes >= n) {
+            std::vector<value_type> p(n + 1);
+            std::vector<std::vector<int>> pred(1, std::vector<int>(n + 1));
+            splitter.layer(p, p, pred[0], true);
+            if (p[n] == Splitter<Cost>::INFINITE) return std::list<Tour>();
+            return splitter.routes(pred, 0);
+        }
+
+        // Layer k holds the best splits in exactly k routes.
+        std::vector<std::vector<value_type>> p(maxRoutes + 1, std::vector<value_type>(n + 1));
+        std::vector<std::vector<int>> pred(maxRoutes + 1, std::vector<int>(n + 1));
+        std::fill(p[0].begin(), p[0].end(), Splitter<Cost>::INFINITE);
+        p[0][0] = 0;
+        int best = -1;
+        for (int k = 1; k <= maxRoutes; k++) {
+            splitter.layer(p[k - 1], p[k], pred[k], false);
+            if (p[k][n] < Splitter<Cost>::INFINITE && (best < 0 || p[k][n] < p[best][n])) best = k;
+        }
+        if (best < 0) return std::list<Tour>();
+        return splitter.routes(pred, best);
+    }
+
+} // namespace
+
+    std::list<Tour> split(const Graph &g, const std::vector<int> &giantTour, int maxRoutes) {
+        if (g.hasIntegerCosts()) return split<IntCost>(g, giantTour, maxRoutes);
+        return split<RealCost>(g, giantTour, maxRoutes);
+    }
+
+    std::vector<int> giantTour(const std::list<Tour> &tours) {
+        std::vector<int> giantTour;
+        for (const Tour &t : tours) giantTour.insert(giantTour.end(), t.cities.begin(), t.cities.end());
+        return giantTour;
+    }
+
+    std::list<Tour> routeFirst(const Graph &g, TspStart start, int maxRoutes) {
+        lemon::FullGraph::EdgeMap<double> costs(g);
+        for (lemon::FullGraph::EdgeIt e(g); e != lemon::INVALID; ++e) {
+            costs[e] = g.getDistance(g.u(e), g.v(e));
+        }
+
+        lemon::Opt2Tsp<lemon::FullGraph::EdgeMap<double>> opt2(g, costs);
+        if (start == TspStart::Christofides) {
+            lemon::ChristofidesTsp<lemon::FullGraph::EdgeMap<double>> christofides(g, costs);
+            christofides.run();
+            opt2.run(christofides.tourNodes());
+        } else {
+            opt2.run();
+        }
+
+        // Cut the cycle at the depot.
+        const std::vector<lemon::FullGraph::Node> &nodes = opt2.tourNodes();
+        std::vector<int> giantTour;
+        giantTour.reserve(nodes.size());
+        auto depot = std::find(nodes.begin(), nodes.end(), g.nodeFromId(g.depotId()));
+        for (auto it = depot + 1; it != nodes.end(); ++it) giantTour.push_back(g.id(*it));
+        for (auto it = nodes.begin(); it != depot; ++it) giantTour.push_back(g.id(*it));
+        return split(g, giantTour, maxRoutes);
+    }
+}
+}
@@ -0,0 +1,54 @@
+#ifndef PMAOA_SPLIT_H
+#define PMAOA_SPLIT_H
+
+#include <vector>
+
+#include "graph.h"
+
+namespace maoa {
+    namespace split {
+
+        /*!
+         * Optimal partition of a giant tour into capacity-feasible routes,
+         * keeping the order of the customers (Prins' Split).
+         *
+         * Without fleet limit this is the O(n) deque-based variant of Vidal
+         * (2016): the predecessors that can still start a route ending at the
+         * current customer form a sliding window, whose best element is kept
+         * at the front of a monotonic deque. With a limit of K routes, the
+         * same procedure is run once per route count, in O(nK).
+         *
+         * Costs are evaluated with the integer costs of the graph if it has
+         * them, see cost.h.
+         *
+         * @param g Graph of the customers.
+         * @param giantTour Every customer once, without the depot.
+         * @param maxRoutes Maximum number of routes, 0 for no limit.
+         * @return The routes, with their load, cost and hash. Empty if no
+         * partition is feasible (a customer heavier than the capacity, or
+         * too few routes).
+         */
+        std::list<Tour> split(const Graph &g, const std::vector<int> &giantTour, int maxRoutes = 0);
+
+        /*! Giant tour made of the cities of \a tours, in order. */
+        std::vector<int> giantTour(const std::list<Tour> &tours);
+
+        /*! TSP heuristic of LEMON used to build the giant tour of routeFirst(). */
+        enum class TspStart {
+            /*! Christofides' tour improved by 2-opt, O(n^3). */
+            Christofides,
+            /*! 2-opt from the node order, which follows a space-filling curve
+             * on a renumbered graph (see LoadOptions::renumber). */
+            Opt2
+        };
+
+        /*!
+         * Route-first cluster-second construction: a TSP tour over all the
+         * nodes, cut at the depot and split into routes.
+         * @return The routes, empty if no partition is feasible (see split()).
+         */
+        std::list<Tour> routeFirst(const Graph &g, TspStart start = TspStart::Christofides, int maxRoutes = 0);
+    }
+}
+
+#endif //PMAOA_SPLIT_H
@@ -8,6 +8,7 @@
 #include "../draw.h"
 #include <cstring>
 #include "../aco_heuristic.h"
+#include "../solution_io.h"
 
 std::vector<std::string> getFileNames(const std::string &dirpath)
 {
@@ -34,13 +35,26 @@ std::vector<std::string> getFileNames(const std::string &dirpath)
 }
 
 int main() {
-    auto filenames = getFileNames("../data/B/");
+    int failures = 0;
+    auto filenames = getFileNames("../data/A/");
     for (auto &s : filenames) {
         std::cout << "Starting ace heuristic for: " << s << std::endl;
-        maoa::Graph g("../data/B/" + s);
-        ace::aco_heuristic ace("../data/B/" + s);
+        maoa::InstanceData data;
+        maoa::ParseStatus status = maoa::parseVrpFile("../data/A/" + s, data);
+        if (status != maoa::ParseStatus::Ok) {
+            std::cerr << "Skipping " << s << ": " << maoa::parseStatusMessage(status) << std::endl;
+            continue;
+        }
+        maoa::Graph g(data);
+        ace::aco_heuristic ace(data);
         std::list<maoa::Tour> tours = ace.run(20,20,2.3,0.1,0.2,0.00001);
 //        std::cout << "Number of routes: " << tours.size() << std::endl;
+        // An empty result means no ant fitted in the fleet.
+        maoa::sol::ValidationStatus valid = maoa::sol::validate(g, tours);
+        if (!tours.empty() && valid != maoa::sol::ValidationStatus::Valid) {
+            std::cerr << "Invalid solution for " << s << ": " << maoa::sol::validationStatusMessage(valid) << std::endl;
+            failures++;
+        }
         if (g.vehiclesNum() < tours.size()) {
             std::cerr << "Too many routes for " << s << " " << g.vehiclesNum() << " != " << tours.size() << std::endl;
 //            maoa::idesc::descent(tours, g);
@@ -48,4 +62,5 @@ int main() {
 //            drawUtils.drawTours(tours, g);
         }
     }
-}
\ No newline at end of file
+    return failures == 0 ? 0 : 1;
+}
@@ -4,9 +4,11 @@
 #include <vector>
 #include <iostream>
 #include <sstream>
+#include <cstring>
 #include "../iterative_descent.h"
 #include "../draw.h"
 #include "../cw_heuristic.h"
+#include "../solution_io.h"
 
 std::vector<std::string> getFileNames(const std::string &dirpath)
 {
@@ -36,10 +38,20 @@ int main() {
     auto filenames = getFileNames("../data/A/");
     for (auto &s : filenames) {
 //        std::cout << "Starting C&W heuristic for: " << s << std::endl;
-        maoa::Graph g("../data/A/" + s);
-        std::list<maoa::cw::Saving> savings = maoa::cw::computeSavings(g);
+        maoa::InstanceData data;
+        maoa::ParseStatus status = maoa::parseVrpFile("../data/A/" + s, data);
+        if (status != maoa::ParseStatus::Ok) {
+            std::cerr << "Skipping " << s << ": " << maoa::parseStatusMessage(status) << std::endl;
+            continue;
+        }
+        maoa::Graph g(data);
+        maoa::cw::SavingList savings = maoa::cw::computeSavings(g);
         std::list<maoa::Tour> tours = maoa::cw::constructTours(g, savings);
 //        std::cout << "Number of routes: " << tours.size() << std::endl;
+        maoa::sol::ValidationStatus valid = maoa::sol::validate(g, tours);
+        if (valid != maoa::sol::ValidationStatus::Valid && valid != maoa::sol::ValidationStatus::TooManyRoutes) {
+            std::cerr << "Invalid solution for " << s << ": " << maoa::sol::validationStatusMessage(valid) << std::endl;
+        }
         if (g.vehiclesNum() < tours.size()) {
             std::cerr << "Too many routes for " << s << " " << g.vehiclesNum() << " != " << tours.size() << std::endl;
 //            maoa::idesc::descent(tours, g);
@@ -0,0 +1,84 @@
+#include <dirent.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <cstring>
+#include "../cw_heuristic.h"
+#include "../population.h"
+
+std::vector<std::string> getFileNames(const std::string &dirpath)
+{
+    DIR *dirp;
+    struct dirent *directory;
+
+    std::vector<std::string> filenames;
+    dirp = opendir(dirpath.c_str());
+    if (dirp) {
+        while ((directory = readdir(dirp)) != nullptr) {
+            std::string filename(directory->d_name);
+            if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".vrp") == 0) {
+                filenames.emplace_back(filename);
+            }
+        }
+        closedir(dirp);
+    }
+
+    return filenames;
+}
+
+/*! Same routes, in the same order, with the same cities. */
+bool sameTours(const std::list<maoa::Tour> &a, const std::list<maoa::Tour> &b) {
+    if (a.size() != b.size()) return false;
+    auto b_it = b.begin();
+    for (const maoa::Tour &t : a) {
+        if (!std::equal(t.cities.begin(), t.cities.end(), b_it->cities.begin(), b_it->cities.end())) return false;
+        b_it++;
+    }
+    return true;
+}
+
+int main() {
+    int failures = 0;
+    auto filenames = getFileNames("../data/A/");
+    for (auto &s : filenames) {
+        maoa::InstanceData data;
+        maoa::ParseStatus status = maoa::parseVrpFile("../data/A/" + s, data);
+        if (status != maoa::ParseStatus::Ok) {
+            std::cerr << "Skipping " << s << ": " << maoa::parseStatusMessage(status) << std::endl;
+            continue;
+        }
+        maoa::Graph g(data);
+        maoa::cw::SavingList savings = maoa::cw::computeSavings(g);
+        std::list<maoa::Tour> tours = maoa::cw::constructTours(g, savings);
+        maoa::Solution solution(g, tours);
+
+        maoa::Population population(g, 2);
+        const int fromTours = population.add(tours);
+        const int fromSolution = population.add(solution);
+
+        // Encode and decode through both working types.
+        bool ok = population.hash(fromTours) == solution.hash()
+                  && population.hash(fromSolution) == solution.hash()
+                  && population.routeCount(fromTours) == (int) tours.size()
+                  && population.length(fromTours) == population.length(fromSolution);
+        ok = ok && sameTours(population.decode(fromTours), tours);
+        maoa::Solution decoded(g);
+        population.decode(fromSolution, decoded);
+        ok = ok && decoded.isConsistent() && decoded.hash() == solution.hash()
+             && sameTours(decoded.toTours(), tours);
+
+        // Copy into another population, over a different solution.
+        maoa::Population other(g, 1);
+        other.add(std::list<maoa::Tour>(1, tours.front()));
+        other.copy(0, population, fromSolution);
+        ok = ok && other.length(0) == population.length(fromSolution)
+             && other.hash(0) == solution.hash() && other.cost(0) == population.cost(fromSolution)
+             && sameTours(other.decode(0), tours);
+
+        if (!ok) {
+            std::cerr << "Population round trip failed for " << s << std::endl;
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#include <dirent.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include <iostream>
+#include "../split.h"
+#include "../solution_io.h"
+
+std::vector<std::string> getFileNames(const std::string &dirpath)
+{
+    DIR *dirp;
+    struct dirent *directory;
+
+    std::vector<std::string> filenames;
+    dirp = opendir(dirpath.c_str());
+    if (dirp) {
+        while ((directory = readdir(dirp)) != nullptr) {
+            std::string filename(directory->d_name);
+            if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".vrp") == 0) {
+                filenames.emplace_back(filename);
+            }
+        }
+        closedir(dirp);
+    }
+
+    return filenames;
+}
+
+/*!
+ * Reference O(n^2 K) Bellman split: best[k][t] is the cheapest split of the
+ * first t customers of \a giantTour in exactly k routes.
+ * @return The cheapest cost with at most \a maxRoutes routes (0 for no
+ * limit), infinity if there is none.
+ */
+double bellmanSplit(const maoa::Graph &g, const std::vector<int> &giantTour, int maxRoutes) {
+    const double INF = std::numeric_limits<double>::infinity();
+    const int n = (int) giantTour.size(), depotId = g.depotId();
+    if (maxRoutes <= 0) maxRoutes = n;
+    std::vector<std::vector<double>> best(maxRoutes + 1, std::vector<double>(n + 1, INF));
+    best[0][0] = 0;
+    double result = INF;
+    for (int k = 1; k <= maxRoutes; k++) {
+        for (int i = 0; i < n; i++) {
+            if (best[k - 1][i] == INF) continue;
+            float load = 0;
+            double distance = 0;
+            for (int t = i + 1; t <= n; t++) {
+                load += g.getDemand(giantTour[t - 1]);
+                if (load > g.capacity()) break;
+                if (t > i + 1) distance += g.getDistance(giantTour[t - 2], giantTour[t - 1]);
+                const double cost = g.getDistance(depotId, giantTour[i]) + distance
+                                    + g.getDistance(giantTour[t - 1], depotId);
+                best[k][t] = std::min(best[k][t], best[k - 1][i] + cost);
+            }
+        }
+        result = std::min(result, best[k][n]);
+    }
+    return result;
+}
+
+double totalCost(const std::list<maoa::Tour> &tours) {
+    double cost = 0;
+    for (const maoa::Tour &t : tours) cost += t.cost;
+    return cost;
+}
+
+int main() {
+    int failures = 0;
+    std::mt19937 random(1);
+    auto filenames = getFileNames("../data/A/");
+    for (auto &s : filenames) {
+        maoa::InstanceData data;
+        maoa::ParseStatus status = maoa::parseVrpFile("../data/A/" + s, data);
+        if (status != maoa::ParseStatus::Ok) {
+            std::cerr << "Skipping " << s << ": " << maoa::parseStatusMessage(status) << std::endl;
+            continue;
+        }
+        maoa::Graph g(data);
+        std::vector<int> giantTour;
+        for (int i = 0; i < g.nodeNum(); i++) {
+            if (i != g.depotId()) giantTour.push_back(i);
+        }
+
+        // Linear split and the fleet limited one against the Bellman split, on random orders.
+        for (int trial = 0; trial < 5; trial++) {
+            std::shuffle(giantTour.begin(), giantTour.end(), random);
+            for (int maxRoutes : {0, g.vehiclesNum(), g.vehiclesNum() + 2}) {
+                const std::list<maoa::Tour> tours = maoa::split::split(g, giantTour, maxRoutes);
+                const double expected = bellmanSplit(g, giantTour, maxRoutes);
+                bool ok;
+                if (std::isinf(expected)) {
+                    ok = tours.empty();
+                } else {
+                    maoa::sol::ValidationStatus valid = maoa::sol::validate(g, tours);
+                    ok = std::fabs(totalCost(tours) - expected) < 1e-6 * expected
+                         && (valid == maoa::sol::ValidationStatus::Valid
+                             || (valid == maoa::sol::ValidationStatus::TooManyRoutes && maoa::split::giantTour(tours) == giantTour))
+                         && (maxRoutes == 0 || (int) tours.size() <= maxRoutes);
+                }
+                if (!ok) {
+                    std::cerr << "Split differs from the Bellman split for " << s << " (maxRoutes " << maxRoutes
+                              << "): " << totalCost(tours) << " != " << expected << std::endl;
+                    failures++;
+                }
+            }
+        }
+
+        // Route-first start: every customer once, within the capacity.
+        const std::list<maoa::Tour> tours = maoa::split::routeFirst(g);
+        maoa::sol::ValidationStatus valid = maoa::sol::validate(g, tours);
+        if (valid != maoa::sol::ValidationStatus::Valid && valid != maoa::sol::ValidationStatus::TooManyRoutes) {
+            std::cerr << "Invalid route-first solution for " << s << ": "
+                      << maoa::sol::validationStatusMessage(valid) << std::endl;
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <random>
+#include <vector>
+#include <iostream>
+#include "../route.h"
+#include "../two_level_route.h"
+
+/*! Same first, last, next and prev as the reference, for every city. */
+bool sameOrder(const maoa::TwoLevelRoute &route, const maoa::Route &reference) {
+    if (route.first() != reference.first() || route.last() != reference.last()) return false;
+    for (int k = 0; k < reference.size(); k++) {
+        const int c = reference[k];
+        if (route.next(c) != reference.next(c) || route.prev(c) != reference.prev(c)) return false;
+    }
+    return true;
+}
+
+/*! Same cities as the reference once written back into a Tour. */
+bool sameCopy(const maoa::TwoLevelRoute &route, const maoa::Route &reference, maoa::Tour &tour) {
+    route.copyTo(tour);
+    if ((int) tour.cities.size() != reference.size()) return false;
+    int k = 0;
+    for (int c : tour.cities) {
+        if (c != reference[k++]) return false;
+    }
+    return true;
+}
+
+int main() {
+    const int routeNum = 20, reversalNum = 20000, sampleNum = 4;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> sizes(maoa::TwoLevelRoute::MIN_SIZE, 5 * maoa::TwoLevelRoute::MIN_SIZE);
+    int failures = 0;
+
+    // A few degenerate sizes first, then routes in the range where the
+    // operators switch to the two-level list.
+    std::vector<int> routeSizes = {1, 2, 3, 7};
+    for (int r = 0; r < routeNum; r++) routeSizes.push_back(sizes(rng));
+
+    for (int n : routeSizes) {
+        // Cities are shuffled so that the natural order of the segments is
+        // not the order of the node indices.
+        maoa::Tour tour;
+        std::vector<int> cities(n);
+        for (int i = 0; i < n; i++) cities[i] = i + 1;
+        std::shuffle(cities.begin(), cities.end(), rng);
+        for (int c : cities) tour.addCity(c, 1);
+
+        maoa::Route reference(tour, n + 1);
+        maoa::TwoLevelRoute route(n + 1);
+        route.assign(tour);
+        bool ok = route.size() == n && route.load() == reference.load() && sameOrder(route, reference);
+
+        std::uniform_int_distribution<int> positions(0, n - 1);
+        for (int it = 0; ok && it < reversalNum; it++) {
+            int i = positions(rng), j = positions(rng);
+            if (i > j) std::swap(i, j);
+            const int from = reference[i], to = reference[j];
+            reference.reversePath(from, to);
+            route.reversePath(from, to);
+
+            ok = route.first() == reference.first() && route.last() == reference.last();
+            for (int k = 0; ok && k < sampleNum; k++) {
+                const int c = reference[positions(rng)];
+                ok = route.next(c) == reference.next(c) && route.prev(c) == reference.prev(c);
+                int a = reference[positions(rng)], b = reference[positions(rng)], d = reference[positions(rng)];
+                if (reference.position(a) > reference.position(d)) std::swap(a, d);
+                ok = ok && route.between(a, b, d) == reference.between(a, b, d);
+            }
+            if (ok && (it + 1) % 1000 == 0) ok = sameOrder(route, reference);
+        }
+        ok = ok && sameOrder(route, reference) && sameCopy(route, reference, tour);
+
+        if (!ok) {
+            std::cerr << "TwoLevelRoute differs from Route for a route of " << n << " cities" << std::endl;
+            failures++;
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
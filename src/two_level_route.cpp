@@ -0,0 +1,116 @@
+#include <cmath>
+
+#include "two_level_route.h"
+
+namespace maoa {
+
+    TwoLevelRoute::TwoLevelRoute(int nodeNum)
+            : _parent(nodeNum, -1), _seq(nodeNum, 0), _prev(nodeNum, -1), _next(nodeNum, -1),
+              _firstSegment(-1), _lastSegment(-1), _size(0), _maxSegments(0), _load(0) {}
+
+    void TwoLevelRoute::assign(const Tour &t) {
+        _buffer.assign(t.cities.begin(), t.cities.end());
+        _build();
+        _load = t.capacity;
+    }
+
+    void TwoLevelRoute::copyTo(Tour &t) const {
+        auto c_it = t.cities.begin();
+        int c = first();
+        for (; c_it != t.cities.end() && c >= 0; c_it++, c = next(c)) *c_it = c;
+        t.cities.erase(c_it, t.cities.end());
+        for (; c >= 0; c = next(c)) t.cities.push_back(c);
+        t.capacity = _load;
+    }
+
+    void TwoLevelRoute::_build() {
+        _segments.clear();
+        _size = (int) _buffer.size();
+        _firstSegment = _lastSegment = -1;
+        if (_size == 0) return;
+
+        const int groupSize = std::max(1, (int) std::ceil(std::sqrt((double) _size)));
+        for (int begin = 0; begin < _size; begin += groupSize) {
+            const int end = std::min(begin + groupSize, _size) - 1;
+            const int s = (int) _segments.size();
+            _segments.push_back(Segment{_buffer[begin], _buffer[end], s - 1, -1, s, false});
+            if (s > 0) _segments[s - 1].next = s;
+            for (int k = begin; k <= end; k++) {
+                const int c = _buffer[k];
+                _parent[c] = s;
+                _seq[c] = k;
+                _prev[c] = (k > begin) ? _buffer[k - 1] : -1;
+                _next[c] = (k < end) ? _buffer[k + 1] : -1;
+            }
+        }
+        _firstSegment = 0;
+        _lastSegment = (int) _segments.size() - 1;
+        _maxSegments = 2 * (int) _segments.size();
+    }
+
+    void TwoLevelRoute::_rebuild() {
+        _buffer.clear();
+        for (int c = first(); c >= 0; c = next(c)) _buffer.push_back(c);
+        _build();
+    }
+
+    void TwoLevelRoute::_splitBefore(int c) {
+        const int s = _parent[c];
+        if (_head(s) == c) return;
+
+        // The new segment t gets c and the cities after it in route order,
+        // which are at the end of s in natural order unless s is reversed.
+        const int t = (int) _segments.size();
+        Segment seg = _segments[s];
+        if (!seg.reversed) {
+            seg.last = _prev[c];
+            _segments.push_back(Segment{c, _segments[s].last, s, seg.next, seg.rank + 1, false});
+            _next[_prev[c]] = -1;
+            _prev[c] = -1;
+        } else {
+            seg.first = _next[c];
+            _segments.push_back(Segment{_segments[s].first, c, s, seg.next, seg.rank + 1, true});
+            _prev[_next[c]] = -1;
+            _next[c] = -1;
+        }
+        for (int k = _segments[t].first; k >= 0; k = _next[k]) _parent[k] = t;
+
+        if (seg.next >= 0) _segments[seg.next].prev = t;
+        else _lastSegment = t;
+        seg.next = t;
+        _segments[s] = seg;
+        for (int k = _segments[t].next; k >= 0; k = _segments[k].next) _segments[k].rank++;
+    }
+
+    void TwoLevelRoute::reversePath(int from, int to) {
+        if (from == to) return;
+        _splitBefore(from);
+        const int after = next(to);
+        if (after >= 0) _splitBefore(after);
+
+        // Reverse the chain of segments from the one of `from` to the one of `to`.
+        const int first = _parent[from], last = _parent[to];
+        const int before = _segments[first].prev, behind = _segments[last].next;
+        int rank = _segments[first].rank;
+        _buffer.clear();
+        for (int s = last; ; s = _segments[s].prev) {
+            _buffer.push_back(s);
+            if (s == first) break;
+        }
+        int previous = before;
+        for (int s : _buffer) {
+            Segment &seg = _segments[s];
+            seg.reversed = !seg.reversed;
+            seg.rank = rank++;
+            seg.prev = previous;
+            if (previous >= 0) _segments[previous].next = s;
+            else _firstSegment = s;
+            previous = s;
+        }
+        _segments[previous].next = behind;
+        if (behind >= 0) _segments[behind].prev = previous;
+        else _lastSegment = previous;
+
+        if ((int) _segments.size() > _maxSegments) _rebuild();
+    }
+}
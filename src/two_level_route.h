@@ -0,0 +1,105 @@
+#ifndef PMAOA_TWO_LEVEL_ROUTE_H
+#define PMAOA_TWO_LEVEL_ROUTE_H
+
+#include <vector>
+
+#include "graph.h"
+
+namespace maoa {
+
+    /*!
+     * Route stored as a two-level doubly-linked list: the cities are split in
+     * about sqrt(n) segments, each with a reversal bit, and the segments are
+     * chained in route order. Reversing a path only splits the two segments
+     * at its ends and reverses the chain of segments in between, so it costs
+     * O(sqrt(n)) instead of O(n) for \p Route. It is meant for routes of
+     * thousands of cities; shorter routes are faster as a plain array.
+     *
+     * It has the same navigation interface as \p Route: first(), last(),
+     * next(), prev(), between() and reversePath(). The depot is implicit at
+     * both ends, next() of the last city and prev() of the first are -1.
+     *
+     * Segments are only split by reversals, never merged: once there are
+     * twice as many as after a rebuild, the route is rebuilt in O(n), which
+     * keeps the amortized cost of a reversal in O(sqrt(n)).
+     */
+    class TwoLevelRoute {
+    public:
+        /*! Route length from which the operators switch from Route to TwoLevelRoute. */
+        static const int MIN_SIZE = 1000;
+
+        /*!
+         * Creates an empty route.
+         * @param nodeNum Number of nodes of the graph, size of the node index.
+         */
+        explicit TwoLevelRoute(int nodeNum = 0);
+
+        /*! Replaces the cities of the route with those of \a t. */
+        void assign(const Tour &t);
+        /*! Writes the cities back into \a t, reusing its list nodes. */
+        void copyTo(Tour &t) const;
+
+        int size() const { return _size; }
+        bool empty() const { return _size == 0; }
+        /*! Sum of the demands of the cities. */
+        float load() const { return _load; }
+        int first() const { return _size == 0 ? -1 : _head(_firstSegment); }
+        int last() const { return _size == 0 ? -1 : _tail(_lastSegment); }
+        /*! City after \a c, -1 if \a c is the last one. O(1). */
+        int next(int c) const {
+            const Segment &s = _segments[_parent[c]];
+            const int n = s.reversed ? _prev[c] : _next[c];
+            if (n >= 0 || s.next < 0) return n;
+            return _head(s.next);
+        }
+        /*! City before \a c, -1 if \a c is the first one. O(1). */
+        int prev(int c) const {
+            const Segment &s = _segments[_parent[c]];
+            const int p = s.reversed ? _next[c] : _prev[c];
+            if (p >= 0 || s.prev < 0) return p;
+            return _tail(s.prev);
+        }
+        /*! True if \a b is on the path from \a a to \a c (both included),
+         * which requires \a a before \a c. O(1). */
+        bool between(int a, int b, int c) const {
+            return !_before(b, a) && !_before(c, b);
+        }
+        /*! Reverses the path from \a from to \a to, \a from being before \a to. */
+        void reversePath(int from, int to);
+
+    private:
+        struct Segment {
+            int first, last;  // End nodes in natural order.
+            int prev, next;   // Neighbor segments in route order, -1 at the ends.
+            int rank;         // Position of the segment in the route.
+            bool reversed;    // Route order is the natural order reversed.
+        };
+
+        // Per node, in natural order within its segment.
+        std::vector<int> _parent, _seq, _prev, _next;
+        std::vector<Segment> _segments;
+        std::vector<int> _buffer;
+        int _firstSegment, _lastSegment;
+        int _size;
+        // Segment count above which the route is rebuilt.
+        int _maxSegments;
+        float _load;
+
+        int _head(int s) const { return _segments[s].reversed ? _segments[s].last : _segments[s].first; }
+        int _tail(int s) const { return _segments[s].reversed ? _segments[s].first : _segments[s].last; }
+        /*! True if \a a comes strictly before \a b in the route. */
+        bool _before(int a, int b) const {
+            const Segment &sa = _segments[_parent[a]], &sb = _segments[_parent[b]];
+            if (sa.rank != sb.rank) return sa.rank < sb.rank;
+            return sa.reversed ? _seq[a] > _seq[b] : _seq[a] < _seq[b];
+        }
+        /*! Splits the segment of \a c so that \a c becomes the head of a segment. */
+        void _splitBefore(int c);
+        /*! Rebuilds segments of about sqrt(n) cities from the current order. */
+        void _rebuild();
+        /*! Builds the segments of the cities stored in _buffer, in this order. */
+        void _build();
+    };
+}
+
+#endif //PMAOA_TWO_LEVEL_ROUTE_H
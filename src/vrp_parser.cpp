@@ -0,0 +1,367 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "vrp_parser.h"
+
+namespace maoa {
+
+    namespace {
+
+        enum class Section { None, Coord, Demand, Depot, EdgeWeight };
+
+        /*! Parsing state carried from one line to the next. */
+        struct ParserState {
+            Section section = Section::None;
+            bool done = false;
+            // Next cell of the distance matrix to fill in EDGE_WEIGHT_SECTION.
+            int row = 0, col = 0;
+        };
+
+        /*!
+         * Cursor over a single line of the buffer. Tokens are separated by
+         * blanks and ':' so that both "KEY : value" and "KEY: value" work.
+         */
+        struct LineCursor {
+            const char *pos;
+            const char *end;
+
+            static bool isSeparator(char c) {
+                return c == ' ' || c == '\t' || c == '\r' || c == ':';
+            }
+
+            void skipSeparators() {
+                while (pos < end && isSeparator(*pos)) pos++;
+            }
+
+            bool atEnd() {
+                skipSeparators();
+                return pos == end;
+            }
+
+            /*! Returns true and consumes the next token if it is \a word. */
+            bool consume(const char *word) {
+                skipSeparators();
+                size_t len = strlen(word);
+                if ((size_t) (end - pos) < len || strncmp(pos, word, len) != 0) return false;
+                if (pos + len < end && !isSeparator(pos[len])) return false;
+                pos += len;
+                return true;
+            }
+
+            /*! Returns the position of \a word in the remainder of the line,
+             * nullptr if it does not appear. */
+            const char *find(const char *word) const {
+                size_t len = strlen(word);
+                for (const char *p = pos; p + len <= end; p++) {
+                    if (strncmp(p, word, len) == 0) return p;
+                }
+                return nullptr;
+            }
+
+            bool readInt(int &value) {
+                skipSeparators();
+                const char *p = pos;
+                bool negative = false;
+                if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+                if (p == end || *p < '0' || *p > '9') return false;
+                long v = 0;
+                while (p < end && *p >= '0' && *p <= '9') v = v * 10 + (*p++ - '0');
+                if (p < end && !isSeparator(*p)) return false;
+                value = (int) (negative ? -v : v);
+                pos = p;
+                return true;
+            }
+
+            bool readFloat(float &value) {
+                double v;
+                if (!readDouble(v)) return false;
+                value = (float) v;
+                return true;
+            }
+
+            bool readDouble(double &value) {
+                skipSeparators();
+                const char *p = pos;
+                bool negative = false;
+                if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+                // Accumulate all digits in an integer mantissa and divide once
+                // by an exact power of ten, which keeps the result correctly
+                // rounded for the short numbers found in instance files.
+                unsigned long long mantissa = 0;
+                int digits = 0, exponent = 0;
+                while (p < end && *p >= '0' && *p <= '9') {
+                    mantissa = mantissa * 10 + (*p++ - '0');
+                    digits++;
+                }
+                if (p < end && *p == '.') {
+                    p++;
+                    while (p < end && *p >= '0' && *p <= '9') {
+                        mantissa = mantissa * 10 + (*p++ - '0');
+                        digits++;
+                        exponent--;
+                    }
+                }
+                if (digits == 0 || digits > 19) return false;
+                if (p < end && (*p == 'e' || *p == 'E')) {
+                    p++;
+                    bool negExp = false;
+                    if (p < end && (*p == '-' || *p == '+')) negExp = *p++ == '-';
+                    if (p == end || *p < '0' || *p > '9') return false;
+                    int e = 0;
+                    while (p < end && *p >= '0' && *p <= '9' && e < 1000) e = e * 10 + (*p++ - '0');
+                    exponent += negExp ? -e : e;
+                }
+                if (p < end && !isSeparator(*p)) return false;
+                double v = (double) mantissa;
+                double scale = 1;
+                for (int e = exponent < 0 ? -exponent : exponent; e > 0; e--) scale *= 10;
+                v = exponent < 0 ? v / scale : v * scale;
+                value = negative ? -v : v;
+                pos = p;
+                return true;
+            }
+
+            /*! Reads the first run of digits found after position \a from,
+             * whatever follows it (as in "No of trucks: 5, ..."). */
+            bool readFirstIntAfter(const char *from, int &value) {
+                pos = from;
+                while (pos < end && (*pos < '0' || *pos > '9')) pos++;
+                if (pos == end) return false;
+                value = 0;
+                while (pos < end && *pos >= '0' && *pos <= '9') value = value * 10 + (*pos++ - '0');
+                return true;
+            }
+        };
+
+        ParseStatus readNodeId(LineCursor &line, const InstanceData &data, int &nodeId) {
+            if (!line.readInt(nodeId)) return ParseStatus::BadNumber;
+            nodeId -= 1;
+            if (nodeId < 0 || nodeId >= data.dimension) return ParseStatus::NodeOutOfRange;
+            return ParseStatus::Ok;
+        }
+
+        /*! Returns true when every cell of the matrix has been read. */
+        bool weightsComplete(const ParserState &state, const InstanceData &data) {
+            const int n = data.dimension;
+            switch (data.edgeWeightFormat) {
+                case EdgeWeightFormat::UpperRow: return state.row >= n - 1;
+                default: return state.row >= n;
+            }
+        }
+
+        /*! Stores one value of EDGE_WEIGHT_SECTION and moves to the next cell
+         * according to the matrix layout. */
+        void storeWeight(double w, ParserState &state, InstanceData &data) {
+            const int n = data.dimension;
+            int &r = state.row, &c = state.col;
+            data.distances.at(r, c) = w;
+            if (data.edgeWeightFormat != EdgeWeightFormat::FullMatrix) data.distances.at(c, r) = w;
+            c++;
+            switch (data.edgeWeightFormat) {
+                case EdgeWeightFormat::FullMatrix:
+                    if (c == n) { r++; c = 0; }
+                    break;
+                case EdgeWeightFormat::UpperRow:
+                    if (c == n) { r++; c = r + 1; }
+                    break;
+                case EdgeWeightFormat::UpperDiagRow:
+                    if (c == n) { r++; c = r; }
+                    break;
+                case EdgeWeightFormat::LowerRow:
+                    if (c == r) { r++; c = 0; }
+                    break;
+                case EdgeWeightFormat::LowerDiagRow:
+                    if (c > r) { r++; c = 0; }
+                    break;
+            }
+        }
+
+        void startWeights(ParserState &state, InstanceData &data) {
+            const int n = data.dimension;
+            data.distances.resize(n);
+            for (int i = 0; i < n; i++) data.distances.at(i, i) = 0;
+            state.row = data.edgeWeightFormat == EdgeWeightFormat::LowerRow ? 1 : 0;
+            state.col = data.edgeWeightFormat == EdgeWeightFormat::UpperRow ? 1 : 0;
+        }
+
+        ParseStatus parseLine(LineCursor &line, ParserState &state, InstanceData &data) {
+            if (line.atEnd()) return ParseStatus::Ok;
+
+            // Matrix values may be spread over any number of lines, the
+            // section only ends once every cell has been read.
+            if (state.section == Section::EdgeWeight) {
+                double w;
+                while (!line.atEnd()) {
+                    if (weightsComplete(state, data)) break;
+                    // A keyword here means the section ended too early.
+                    if (!line.readDouble(w)) return ParseStatus::MissingWeights;
+                    storeWeight(w, state, data);
+                }
+                if (weightsComplete(state, data)) state.section = Section::None;
+                return ParseStatus::Ok;
+            }
+
+            // Section keywords.
+            if (line.consume("NODE_COORD_SECTION") || line.consume("DISPLAY_DATA_SECTION")) {
+                state.section = Section::Coord;
+                return data.dimension > 0 ? ParseStatus::Ok : ParseStatus::BadDimension;
+            }
+            if (line.consume("DEMAND_SECTION")) {
+                state.section = Section::Demand;
+                return data.dimension > 0 ? ParseStatus::Ok : ParseStatus::BadDimension;
+            }
+            if (line.consume("DEPOT_SECTION")) {
+                state.section = Section::Depot;
+                return data.dimension > 0 ? ParseStatus::Ok : ParseStatus::BadDimension;
+            }
+            if (line.consume("EDGE_WEIGHT_SECTION")) {
+                if (data.dimension <= 0) return ParseStatus::BadDimension;
+                if (data.edgeWeightType != EdgeWeightType::Explicit) return ParseStatus::Unsupported;
+                state.section = Section::EdgeWeight;
+                startWeights(state, data);
+                return ParseStatus::Ok;
+            }
+            if (line.consume("EOF")) {
+                state.done = true;
+                return ParseStatus::Ok;
+            }
+
+            // Header keywords. They all come before the first section.
+            const Section section = state.section;
+            const char *trucks = section == Section::None ? line.find("trucks") : nullptr;
+            if (trucks != nullptr || (section == Section::None && line.find("VEHICLES") != nullptr)) {
+                const char *from = trucks != nullptr ? trucks : line.pos;
+                int vehicles;
+                if (!line.readFirstIntAfter(from, vehicles)) return ParseStatus::BadNumber;
+                data.vehicles = vehicles;
+                return ParseStatus::Ok;
+            }
+            if (line.consume("DIMENSION")) {
+                int dimension;
+                if (!line.readInt(dimension) || dimension <= 0) return ParseStatus::BadDimension;
+                data.dimension = dimension;
+                data.x.assign(dimension, 0);
+                data.y.assign(dimension, 0);
+                data.demand.assign(dimension, 0);
+                return ParseStatus::Ok;
+            }
+            if (line.consume("CAPACITY")) {
+                return line.readFloat(data.capacity) ? ParseStatus::Ok : ParseStatus::BadCapacity;
+            }
+            if (line.consume("EDGE_WEIGHT_TYPE")) {
+                if (line.consume("EUC_2D")) data.edgeWeightType = EdgeWeightType::Euc2D;
+                else if (line.consume("CEIL_2D")) data.edgeWeightType = EdgeWeightType::Ceil2D;
+                else if (line.consume("EXPLICIT")) data.edgeWeightType = EdgeWeightType::Explicit;
+                else if (line.consume("ATT")) data.edgeWeightType = EdgeWeightType::Att;
+                else if (line.consume("GEO")) data.edgeWeightType = EdgeWeightType::Geo;
+                else if (line.consume("MAN_2D")) data.edgeWeightType = EdgeWeightType::Man2D;
+                else return ParseStatus::Unsupported;
+                return ParseStatus::Ok;
+            }
+            if (line.consume("EDGE_WEIGHT_FORMAT")) {
+                if (line.consume("FULL_MATRIX")) data.edgeWeightFormat = EdgeWeightFormat::FullMatrix;
+                else if (line.consume("UPPER_ROW")) data.edgeWeightFormat = EdgeWeightFormat::UpperRow;
+                else if (line.consume("LOWER_ROW")) data.edgeWeightFormat = EdgeWeightFormat::LowerRow;
+                else if (line.consume("UPPER_DIAG_ROW")) data.edgeWeightFormat = EdgeWeightFormat::UpperDiagRow;
+                else if (line.consume("LOWER_DIAG_ROW")) data.edgeWeightFormat = EdgeWeightFormat::LowerDiagRow;
+                else return ParseStatus::Unsupported;
+                return ParseStatus::Ok;
+            }
+
+            // Section data.
+            int nodeId;
+            ParseStatus status;
+            switch (section) {
+                case Section::Coord:
+                    if ((status = readNodeId(line, data, nodeId)) != ParseStatus::Ok) return status;
+                    if (!line.readFloat(data.x[nodeId]) || !line.readFloat(data.y[nodeId])) {
+                        return ParseStatus::BadNumber;
+                    }
+                    break;
+                case Section::Demand:
+                    if ((status = readNodeId(line, data, nodeId)) != ParseStatus::Ok) return status;
+                    if (!line.readFloat(data.demand[nodeId])) return ParseStatus::BadNumber;
+                    break;
+                case Section::Depot:
+                    // Only the first depot is used, the list ends with -1.
+                    if ((status = readNodeId(line, data, nodeId)) != ParseStatus::Ok) return status;
+                    data.depotId = nodeId;
+                    state.section = Section::None;
+                    break;
+                case Section::None:
+                case Section::EdgeWeight:
+                    // Unknown header (NAME, COMMENT, TYPE...), ignored.
+                    break;
+            }
+            return ParseStatus::Ok;
+        }
+    }
+
+    const char *parseStatusMessage(ParseStatus status) {
+        switch (status) {
+            case ParseStatus::Ok: return "ok";
+            case ParseStatus::CannotOpen: return "unable to open file";
+            case ParseStatus::BadDimension: return "missing or invalid DIMENSION";
+            case ParseStatus::BadCapacity: return "missing or invalid CAPACITY";
+            case ParseStatus::BadNumber: return "malformed number";
+            case ParseStatus::NodeOutOfRange: return "node id out of range";
+            case ParseStatus::MissingDepot: return "missing DEPOT_SECTION";
+            case ParseStatus::Unsupported: return "unsupported EDGE_WEIGHT_TYPE or EDGE_WEIGHT_FORMAT";
+            case ParseStatus::MissingWeights: return "missing or incomplete EDGE_WEIGHT_SECTION";
+            case ParseStatus::BadSnapshot: return "invalid or truncated snapshot";
+        }
+        return "unknown error";
+    }
+
+    ParseStatus parseVrpBuffer(const char *begin, const char *end, InstanceData &data) {
+        data = InstanceData();
+        ParserState state;
+
+        const char *lineBegin = begin;
+        while (lineBegin < end && !state.done) {
+            const char *lineEnd = static_cast<const char *>(memchr(lineBegin, '\n', end - lineBegin));
+            if (lineEnd == nullptr) lineEnd = end;
+
+            LineCursor line{lineBegin, lineEnd};
+            ParseStatus status = parseLine(line, state, data);
+            if (status != ParseStatus::Ok) return status;
+
+            lineBegin = lineEnd + 1;
+        }
+
+        if (data.dimension <= 0) return ParseStatus::BadDimension;
+        if (data.capacity <= 0) return ParseStatus::BadCapacity;
+        if (data.depotId < 0) return ParseStatus::MissingDepot;
+        if (data.edgeWeightType == EdgeWeightType::Explicit
+                && (data.distances.empty() || !weightsComplete(state, data))) {
+            return ParseStatus::MissingWeights;
+        }
+        if (data.vehicles <= 0) data.vehicles = data.dimension - 1;
+        return ParseStatus::Ok;
+    }
+
+    ParseStatus parseVrpFile(const std::string &filename, InstanceData &data) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return ParseStatus::CannotOpen;
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            return ParseStatus::CannotOpen;
+        }
+
+        size_t size = (size_t) st.st_size;
+        void *mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapped == MAP_FAILED) return ParseStatus::CannotOpen;
+        madvise(mapped, size, MADV_SEQUENTIAL);
+
+        const char *begin = static_cast<const char *>(mapped);
+        ParseStatus status = parseVrpBuffer(begin, begin + size, data);
+        munmap(mapped, size);
+        return status;
+    }
+}
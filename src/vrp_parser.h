@@ -0,0 +1,85 @@
+#ifndef PMAOA_VRP_PARSER_H
+#define PMAOA_VRP_PARSER_H
+
+#include <string>
+#include <vector>
+
+#include "distance_matrix.h"
+
+namespace maoa {
+
+    /*! Result of parsing a CVRPLIB instance. */
+    enum class ParseStatus {
+        Ok,
+        CannotOpen,     //!< The file could not be opened or mapped.
+        BadDimension,   //!< DIMENSION is missing, malformed or not positive.
+        BadCapacity,    //!< CAPACITY is missing or malformed.
+        BadNumber,      //!< A numeric field could not be read.
+        NodeOutOfRange, //!< A node id is outside [1, DIMENSION].
+        MissingDepot,   //!< DEPOT_SECTION is missing or empty.
+        Unsupported,    //!< Unknown EDGE_WEIGHT_TYPE or EDGE_WEIGHT_FORMAT.
+        MissingWeights, //!< EDGE_WEIGHT_SECTION is missing or incomplete.
+        BadSnapshot     //!< Not a snapshot, wrong version or truncated file.
+    };
+
+    /*! Supported values of the EDGE_WEIGHT_TYPE keyword. The values are
+     * stored in snapshots, new ones go at the end. */
+    enum class EdgeWeightType { Euc2D, Ceil2D, Explicit, Att, Geo, Man2D };
+
+    /*! Rounding applied to distances computed from coordinates. */
+    enum class Rounding {
+        Default, //!< Convention of the EDGE_WEIGHT_TYPE: exact for EUC_2D and MAN_2D, up for CEIL_2D.
+        None,    //!< Exact distance (ATT and GEO are integral by definition).
+        Nint,    //!< Nearest integer, the TSPLIB convention for EUC_2D.
+        Ceil     //!< Rounded up, the TSPLIB convention for CEIL_2D.
+    };
+
+    /*! Supported values of the EDGE_WEIGHT_FORMAT keyword. */
+    enum class EdgeWeightFormat { FullMatrix, UpperRow, LowerRow, UpperDiagRow, LowerDiagRow };
+
+    /*! Returns a human readable description of \a status. */
+    const char *parseStatusMessage(ParseStatus status);
+
+    /*!
+     * Raw content of a CVRPLIB instance file. Node ids are 0-based, i.e. the
+     * node numbered k in the file is stored at index k-1.
+     */
+    struct InstanceData {
+        int dimension = 0;
+        float capacity = 0;
+        /*! Number of vehicles. Defaults to dimension-1 (no limit) when the
+         * file does not specify it. */
+        int vehicles = 0;
+        int depotId = -1;
+        std::vector<float> x, y, demand;
+        EdgeWeightType edgeWeightType = EdgeWeightType::Euc2D;
+        EdgeWeightFormat edgeWeightFormat = EdgeWeightFormat::FullMatrix;
+        /*! Distances read from EDGE_WEIGHT_SECTION, written in place while
+         * parsing, or loaded from a snapshot. Empty for coordinate based
+         * instances read from text. */
+        DistanceMatrix<double> distances;
+        /*! Rounding with which \p distances were computed from coordinates. */
+        Rounding distancesRounding = Rounding::None;
+    };
+
+    /*!
+     * Parses a buffer holding the content of a CVRPLIB instance in a single
+     * pass, without any per-line allocation. The buffer does not need to be
+     * null-terminated.
+     * @param begin First character of the buffer.
+     * @param end One past the last character of the buffer.
+     * @param data Structure filled with the instance.
+     * @return ParseStatus::Ok on success, the cause of the failure otherwise.
+     */
+    ParseStatus parseVrpBuffer(const char *begin, const char *end, InstanceData &data);
+
+    /*!
+     * Memory-maps the file \a filename and parses it with \p parseVrpBuffer.
+     * @param filename Path of the instance file.
+     * @param data Structure filled with the instance.
+     * @return ParseStatus::Ok on success, the cause of the failure otherwise.
+     */
+    ParseStatus parseVrpFile(const std::string &filename, InstanceData &data);
+}
+
+#endif //PMAOA_VRP_PARSER_H
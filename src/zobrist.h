@@ -0,0 +1,36 @@
+#ifndef PMAOA_ZOBRIST_H
+#define PMAOA_ZOBRIST_H
+
+#include <cstdint>
+
+namespace maoa {
+
+    /*!
+     * Zobrist style hashing of routes and solutions.
+     *
+     * Every node has a random 64-bit key (see Graph::edgeKey). The hash of a
+     * route is the sum, modulo 2^64, of the keys of its edges, depot edges
+     * included. Edge keys are symmetric, so the hash does not depend on the
+     * direction of the route, and a move changing k edges updates it with k
+     * additions and subtractions. The hash of a solution is the sum of a
+     * mixed value of each route hash, so it does not depend on the order of
+     * the routes and is updated in O(1) when a route changes.
+     */
+    namespace zobrist {
+
+        /*! Finalizer of splitmix64, a cheap bijective mixing of 64 bits. */
+        inline uint64_t mix(uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        /*! Contribution of a route of hash \a routeHash to the solution hash,
+         * 0 for an empty route. */
+        inline uint64_t routeContribution(uint64_t routeHash) {
+            return routeHash == 0 ? 0 : mix(routeHash);
+        }
+    }
+}
+
+#endif //PMAOA_ZOBRIST_H